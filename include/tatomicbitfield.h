@@ -0,0 +1,53 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tatomicbitfield.h
+//
+// Битовое поле с атомарными операциями над битами
+
+#ifndef __ATOMICBITFIELD_H__
+#define __ATOMICBITFIELD_H__
+
+#include "tbitfield.h"
+#include <atomic>
+
+const int CacheLineSize = 64; // размер строки кэша в байтах
+
+// Эл-ты памяти - std::atomic<TELEM>, установка и сброс битов выполняются
+// через fetch_or/fetch_and, поэтому одновременные изменения разных битов
+// одного эл-та не теряются. Память выделяется с выравниванием на строку
+// кэша и дополняется до целого числа строк, чтобы соседние поля не
+// делили строку кэша. Порядок доступа к памяти задается для каждой операции.
+class TAtomicBitField
+{
+private:
+  int  BitLen;               // длина битового поля
+  std::atomic<TELEM> *pMem;  // память битового поля
+  int  MemLen;               // к-во эл-тов Мем (с дополнением до строки кэша)
+
+  void CheckIndex(const int n) const; // проверка номера бита
+public:
+  TAtomicBitField(int len);
+  TAtomicBitField(const TAtomicBitField &) = delete;
+  TAtomicBitField& operator=(const TAtomicBitField &) = delete;
+  ~TAtomicBitField();
+
+  // доступ к битам
+  int  GetLength(void) const; // получить длину (к-во битов)
+  void SetBit(const int n, std::memory_order order = std::memory_order_seq_cst); // установить бит
+  void ClrBit(const int n, std::memory_order order = std::memory_order_seq_cst); // очистить бит
+  int  GetBit(const int n, std::memory_order order = std::memory_order_seq_cst) const; // получить значение бита
+  bool TestAndSet(const int n, std::memory_order order = std::memory_order_seq_cst);   // установить, вернуть прежнее значение
+  bool TestAndClear(const int n, std::memory_order order = std::memory_order_seq_cst); // очистить, вернуть прежнее значение
+
+  // доступ к памяти (пословно)
+  int  GetMemLen(void) const; // к-во эл-тов Мем
+  const std::atomic<TELEM>* GetMem(void) const; // память (выровнена на строку кэша)
+  TELEM LoadWord(const int i, std::memory_order order = std::memory_order_seq_cst) const;
+  // может не сработать и при равенстве, вызывается в цикле
+  bool CompareExchangeWord(const int i, TELEM &expected, TELEM desired,
+                           std::memory_order order = std::memory_order_seq_cst);
+
+  TBitField ToBitField(void) const; // копия (не атомарна в целом)
+};
+
+#endif
@@ -9,11 +9,14 @@
 #define __BITFIELD_H__
 
 #include <iostream>
+#include <memory_resource>
 
 using namespace std;
 
 typedef unsigned int TELEM;
 
+const int BitFieldAlign = 64; // выравнивание памяти: строка кэша, вектор AVX-512
+
 class TBitField
 {
 private:
@@ -24,16 +27,27 @@ private:
   // методы реализации
   int   GetMemIndex(const int n) const; // индекс в pМем для бита n       (#О2)
   TELEM GetMemMask (const int n) const; // битовая маска для бита n       (#О3)
+  void  Detach(void);                   // собственная копия общей памяти
 public:
-  TBitField(int len);                //                                   (#О1)
+  TBitField(int len, std::pmr::memory_resource *mr = std::pmr::get_default_resource()); //  (#О1)
   TBitField(const TBitField &bf);    //                                   (#П1)
+  TBitField(const TBitField &bf, std::pmr::memory_resource *mr); // копия в памяти из mr
   ~TBitField();                      //                                    (#С)
 
   // доступ к битам
   int GetLength(void) const;      // получить длину (к-во битов)           (#О)
+  std::pmr::memory_resource* GetResource(void) const; // откуда выделена память
   void SetBit(const int n);       // установить бит                       (#О4)
   void ClrBit(const int n);       // очистить бит                         (#П2)
   int  GetBit(const int n) const; // получить значение бита               (#Л1)
+  int  GetCount(void) const;      // к-во установленных битов
+
+  // доступ к памяти (пословно)
+  int GetMemLen(void) const;      // к-во эл-тов Мем
+  int GetPaddedMemLen(void) const;// к-во эл-тов с дополнением до BitFieldAlign байт
+  const TELEM* GetMem(void) const;// память битового поля
+  TELEM* GetMem(void);            // биты за пределами BitLen должны оставаться 0,
+                                  // указатель годен для записи до копирования поля
 
   // битовые операции
   int operator==(const TBitField &bf) const; // сравнение                 (#О5)
@@ -45,11 +59,41 @@ public:
 
   friend istream &operator>>(istream &istr, TBitField &bf);       //      (#О7)
   friend ostream &operator<<(ostream &ostr, const TBitField &bf); //      (#П4)
+
+  // двоичный формат: длина (8 байт) и MemLen эл-тов TELEM
+  void Save(ostream &ostr) const; // запись в двоичном виде
+  void Load(istream &istr);       // чтение из двоичного вида
+};
+
+// Битовое поле только для чтения во внешней памяти (например, в отображенном файле)
+class TBitFieldView
+{
+private:
+  int  BitLen;       // длина битового поля
+  const TELEM *pMem; // память битового поля, не принадлежит объекту
+public:
+  TBitFieldView(const TELEM *mem, int len);
+  TBitFieldView(const TBitField &bf);
+
+  int GetLength(void) const;       // получить длину (к-во битов)
+  int GetBit(const int n) const;   // получить значение бита
+  int GetMemLen(void) const;       // к-во эл-тов Мем
+  const TELEM* GetMem(void) const; // память битового поля
+  TBitField ToBitField(void) const;// копия в виде битового поля
 };
+
 // Структура хранения битового поля
 //   бит.поле - набор битов с номерами от 0 до BitLen
 //   массив pМем рассматривается как последовательность MemLen элементов
 //   биты в эл-тах pМем нумеруются справа налево (от младших к старшим)
+//   память общая у копий (копирование при записи): перед pМем лежит
+//   счетчик ссылок, изменяющие методы сначала заводят собственную копию
+//   память выровнена на BitFieldAlign байт и дополнена нулевыми эл-тами до
+//   кратного BitFieldAlign размера, поэтому векторные циклы могут идти до
+//   GetPaddedMemLen без обработки хвоста; запись в дополнение недопустима
+//   память выделяется из std::pmr::memory_resource, заданного при создании;
+//   результаты операций берут ресурс левого операнда, копия - ресурс
+//   исходного поля, поэтому поле не должно переживать свой ресурс
 // О8 Л2 П4 С2
 
 #endif
@@ -0,0 +1,43 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tbitfieldpool.h
+//
+// Потоковый пул буферов для временных битовых полей
+
+#ifndef __BITFIELDPOOL_H__
+#define __BITFIELDPOOL_H__
+
+#include <cstddef>
+#include <memory_resource>
+
+const int PoolSizeClasses = 8;    // к-во размеров, хранимых потоком
+const int PoolClassCapacity = 32; // к-во буферов одного размера
+
+// Ресурс памяти, возвращающий освобожденные буферы в список свободных
+// своего потока, разбитый по размерам (для полей - по MemLen). Новое поле
+// того же размера берет буфер из списка без обращения к куче, поэтому
+// операции над полями фиксированного универса после разогрева обходятся
+// без new/delete. Буфер, освобожденный в другом потоке, попадает в пул
+// этого потока. Буферы сверх PoolClassCapacity и новых размеров сверх
+// PoolSizeClasses возвращаются в new_delete_resource. После уничтожения
+// пула потока (в т.ч. для полей со статическим временем жизни при выходе
+// из программы) память выделяется и освобождается через new_delete_resource.
+//   TBitField bf(len, &TBitFieldPool::Get());
+// или для всех полей по умолчанию:
+//   std::pmr::set_default_resource(&TBitFieldPool::Get());
+class TBitFieldPool : public std::pmr::memory_resource
+{
+private:
+  TBitFieldPool() = default;
+
+  void* do_allocate(std::size_t bytes, std::size_t align) override;
+  void do_deallocate(void *p, std::size_t bytes, std::size_t align) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+public:
+  static TBitFieldPool& Get(void); // единственный экземпляр
+
+  static long long GetHitCount(void);  // выделений из пула в этом потоке
+  static long long GetMissCount(void); // выделений из кучи в этом потоке
+};
+
+#endif
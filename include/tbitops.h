@@ -0,0 +1,52 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tbitops.h
+//
+// Пословные битовые операции над эл-тами TELEM
+
+#ifndef __BITOPS_H__
+#define __BITOPS_H__
+
+#include "tbitfield.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+const int TELEMBits = 8 * sizeof(TELEM); // к-во битов в эл-те
+
+// к-во единичных битов
+inline int _popcount(TELEM val)
+{
+#if defined(_MSC_VER)
+  return int(__popcnt(val));
+#else
+  return __builtin_popcount(val);
+#endif
+}
+
+// номер младшего единичного бита, val != 0
+inline int _ctz(TELEM val)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, val);
+  return int(index);
+#else
+  return __builtin_ctz(val);
+#endif
+}
+
+// к-во нулевых старших битов, val != 0
+inline int _clz(TELEM val)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse(&index, val);
+  return TELEMBits - 1 - int(index);
+#else
+  return __builtin_clz(val);
+#endif
+}
+
+#endif
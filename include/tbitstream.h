@@ -0,0 +1,75 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tbitstream.h
+//
+// Порционное чтение и запись битового поля, не помещающегося в память
+
+#ifndef __BITSTREAM_H__
+#define __BITSTREAM_H__
+
+#include "tbitfield.h"
+#include <future>
+
+// Формат потока совпадает с TBitField::Save: длина в битах (8 байт),
+// затем эл-ты TELEM. Поток обрабатывается порциями по ChunkLen бит
+// (кратно длине TELEM); пока вызывающий обрабатывает текущую порцию,
+// следующая читается (записывается) в фоне - двойная буферизация.
+
+const int BitStreamChunkLen = 1 << 23; // порция по умолчанию - 1 Мбайт
+
+class TBitStreamReader
+{
+private:
+  istream &Stream;
+  unsigned long long BitLen;  // длина потока в битах
+  unsigned long long ReadPos; // номер первого бита следующей читаемой порции
+  unsigned long long ChunkPos;// номер первого бита текущей порции
+  int  ChunkLen;              // длина порции в битах
+  TBitField Buf0, Buf1;       // буферы двойной буферизации
+  TBitField *pFront, *pBack;  // текущая порция и порция, читаемая в фоне
+  std::future<bool> Pending;  // фоновое чтение в pBack
+
+  bool ReadChunk(TBitField *pBuf); // прочитать порцию в буфер
+  void StartRead(void);            // начать фоновое чтение следующей порции
+public:
+  TBitStreamReader(istream &istr, int chunkLen = BitStreamChunkLen);
+  TBitStreamReader(const TBitStreamReader &) = delete;
+  ~TBitStreamReader();
+
+  unsigned long long GetLength(void) const;   // длина потока в битах
+  int GetChunkLen(void) const;                // длина порции в битах
+  bool Next(void);                            // перейти к следующей порции, false - поток исчерпан
+  const TBitField& GetChunk(void) const;      // текущая порция
+  unsigned long long GetChunkPos(void) const; // номер первого бита текущей порции
+};
+
+class TBitStreamWriter
+{
+private:
+  ostream &Stream;
+  unsigned long long BitLen;  // длина потока в битах
+  unsigned long long WritePos;// номер первого бита заполняемой порции
+  int  ChunkLen;              // длина порции в битах
+  TBitField Buf0, Buf1;       // буферы двойной буферизации
+  TBitField *pFront, *pBack;  // заполняемая порция и порция, записываемая в фоне
+  std::future<void> Pending;  // фоновая запись pBack
+
+  void PrepareChunk(void);    // подготовить pFront под следующую порцию
+public:
+  TBitStreamWriter(ostream &ostr, unsigned long long len, int chunkLen = BitStreamChunkLen);
+  TBitStreamWriter(const TBitStreamWriter &) = delete;
+  ~TBitStreamWriter();
+
+  unsigned long long GetLength(void) const; // длина потока в битах
+  bool IsFull(void) const;                  // все порции записаны
+  TBitField& GetChunk(void);                // порция для заполнения (обнулена)
+  void Commit(void);                        // отдать порцию на запись
+  void Close(void);                         // дождаться окончания записи
+};
+
+// побитовые операции над потоками с ограниченным расходом памяти;
+// длина результата - наибольшая из длин, недостающие биты считаются нулями
+void BitStreamOr (TBitStreamReader &a, TBitStreamReader &b, ostream &ostr);
+void BitStreamAnd(TBitStreamReader &a, TBitStreamReader &b, ostream &ostr);
+
+#endif
@@ -0,0 +1,62 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tblockmap.h
+//
+// Карта свободных блоков с поиском непрерывных участков
+
+#ifndef __BLOCKMAP_H__
+#define __BLOCKMAP_H__
+
+#include "tbitfield.h"
+#include <vector>
+
+// FitFirst - первый подходящий свободный участок
+// FitBest  - наименьший подходящий свободный участок
+enum TBlockFit { FitFirst, FitBest };
+
+const int BlockGroupMemLen = 64; // эл-тов в группе сводки (2048 блоков)
+
+// Блок занят - бит 1. Для каждого эл-та и каждой группы эл-тов хранится
+// сводка нулевых участков: длина нулей от начала (Low), от конца (High) и
+// наибольший участок внутри (Max). Поиск идет по сводкам групп и
+// спускается к эл-там только там, где участок нужной длины может лежать
+// внутри; внутри эл-та участки находятся через ctz инвертированного слова.
+class TBlockMap
+{
+private:
+  template <typename T>
+  struct TZeroRuns   // сводка нулевых участков
+  {
+    T Low, High, Max;
+  };
+
+  TBitField Used;                                 // занятые блоки
+  std::vector<TZeroRuns<unsigned char>> WordRuns; // сводки эл-тов
+  std::vector<TZeroRuns<int>> GroupRuns;          // сводки групп
+  int FreeCount;                                  // к-во свободных блоков
+
+  TELEM GetWord(const int i) const;     // эл-т, биты за пределами длины - 1
+  void  UpdateRuns(const int from, const int to); // пересчитать сводки для эл-тов [from, to)
+  void  CheckRange(const int start, const int len) const;
+  void  FillRange(const int start, const int len, bool used);
+  template <typename F>
+  void  ForEachZeroRun(const int len, F f) const; // перебор свободных участков не короче len
+public:
+  TBlockMap(int len);
+
+  int GetLength(void) const;          // к-во блоков
+  int GetFreeCount(void) const;       // к-во свободных блоков
+  int IsFree(const int n) const;      // блок свободен?
+  const TBitField& GetBitField(void) const; // карта занятых блоков
+
+  // начало свободного участка из len блоков, -1 - не найден
+  int FindZeroRun(const int len, TBlockFit fit = FitFirst) const;
+  // найти и занять участок, -1 - не найден
+  int Allocate(const int len, TBlockFit fit = FitFirst);
+  // занять заданный участок, все блоки должны быть свободны
+  void AllocateRange(const int start, const int len);
+  // освободить участок, все блоки должны быть заняты
+  void FreeRange(const int start, const int len);
+};
+
+#endif
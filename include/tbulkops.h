@@ -0,0 +1,102 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tbulkops.h
+//
+// Параллельные массовые операции над битовыми полями и множествами
+
+#ifndef __BULKOPS_H__
+#define __BULKOPS_H__
+
+#include "tset.h"
+#include "tparallel.h"
+#include <execution>
+#include <type_traits>
+#include <vector>
+
+// Массовые операции над битовыми полями и множествами. Память делится на
+// участки, кратные строке кэша, участки обрабатываются параллельно. Поля
+// короче ParallelMinMemLen эл-тов обрабатываются в одном потоке. Как и у
+// операторов, результат имеет наибольшую из длин аргументов.
+
+const int ParallelMinMemLen = 1 << 16;   // порог распараллеливания (эл-тов)
+const int ParallelChunkMemLen = 1 << 14; // наименьший участок (эл-тов)
+
+TBitField Union(const TBitField &a, const TBitField &b, int threads);        // "или"
+TBitField Intersection(const TBitField &a, const TBitField &b, int threads); // "и"
+TBitField Complement(const TBitField &a, int threads);                      // отрицание
+bool IsEqual(const TBitField &a, const TBitField &b, int threads);          // сравнение
+long long PopCount(const TBitField &a, int threads);                        // к-во единиц
+
+TSet Union(const TSet &a, const TSet &b, int threads);        // объединение
+TSet Intersection(const TSet &a, const TSet &b, int threads); // пересечение
+TSet Complement(const TSet &a, int threads);                  // дополнение
+bool IsEqual(const TSet &a, const TSet &b, int threads);      // сравнение
+long long PopCount(const TSet &a, int threads);               // мощность
+
+// варианты с политикой выполнения: sequenced_policy - один поток,
+// остальные политики - по числу ядер
+template <typename ExecutionPolicy>
+using _enable_if_policy = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int>;
+
+template <typename ExecutionPolicy>
+constexpr int _policy_threads()
+{
+  return std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy> ? 1 : 0;
+}
+
+template <typename ExecutionPolicy, typename T, _enable_if_policy<ExecutionPolicy> = 0>
+T Union(ExecutionPolicy &&, const T &a, const T &b)
+{
+  return Union(a, b, _policy_threads<ExecutionPolicy>());
+}
+
+template <typename ExecutionPolicy, typename T, _enable_if_policy<ExecutionPolicy> = 0>
+T Intersection(ExecutionPolicy &&, const T &a, const T &b)
+{
+  return Intersection(a, b, _policy_threads<ExecutionPolicy>());
+}
+
+template <typename ExecutionPolicy, typename T, _enable_if_policy<ExecutionPolicy> = 0>
+T Complement(ExecutionPolicy &&, const T &a)
+{
+  return Complement(a, _policy_threads<ExecutionPolicy>());
+}
+
+template <typename ExecutionPolicy, typename T, _enable_if_policy<ExecutionPolicy> = 0>
+bool IsEqual(ExecutionPolicy &&, const T &a, const T &b)
+{
+  return IsEqual(a, b, _policy_threads<ExecutionPolicy>());
+}
+
+template <typename ExecutionPolicy, typename T, _enable_if_policy<ExecutionPolicy> = 0>
+long long PopCount(ExecutionPolicy &&, const T &a)
+{
+  return PopCount(a, _policy_threads<ExecutionPolicy>());
+}
+
+// Свертка многих полей (множеств) одной операцией. Поля делятся между
+// потоками, каждый поток накапливает результат в своем поле, затем
+// накопленные поля попарно сливаются деревом. Выделяется по одному полю
+// на поток, а не по временному полю на каждую операцию.
+enum TReduceOp { ReduceUnion, ReduceIntersection };
+
+TBitField _reduce(const TBitField *const *fields, long long count, TReduceOp op, int threads);
+
+TBitField Reduce(const TBitField *fields, long long count, TReduceOp op, int threads = 0);
+TSet Reduce(const TSet *sets, long long count, TReduceOp op, int threads = 0);
+
+inline const TBitField* _bitfield_of(const TBitField &bf) { return &bf; }
+inline const TBitField* _bitfield_of(const TSet &s) { return &s.GetBitField(); }
+
+// свертка диапазона [first, last) из TBitField или TSet
+template <typename It>
+std::decay_t<decltype(*std::declval<It>())> Reduce(It first, It last, TReduceOp op, int threads = 0)
+{
+  std::vector<const TBitField*> fields;
+  for (; first != last; ++first)
+    fields.push_back(_bitfield_of(*first));
+
+  return std::decay_t<decltype(*std::declval<It>())>(_reduce(fields.data(), (long long)fields.size(), op, threads));
+}
+
+#endif
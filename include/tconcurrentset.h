@@ -0,0 +1,98 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tconcurrentset.h
+//
+// Множество с одним писателем и читателями без блокировок
+
+#ifndef __CONCURRENTSET_H__
+#define __CONCURRENTSET_H__
+
+#include "tset.h"
+#include "tatomicbitfield.h"
+#include <atomic>
+#include <vector>
+
+const int ConcurrentChunkLen = 1 << 15; // длина участка в битах (4 Кбайт)
+const int ConcurrentMaxReaders = 64;    // к-во одновременных снимков
+
+// Характеристический вектор разбит на участки по ConcurrentChunkLen бит.
+// Опубликованная версия - неизменяемый каталог указателей на участки.
+// Писатель (один поток) изменяет черновик: при первом изменении участка
+// после публикации участок копируется, остальные участки общие с текущей
+// версией. Publish атомарно подменяет текущую версию черновиком.
+//
+// Читатель берет снимок (TSnapshot) - согласованную версию, которая не
+// меняется и не освобождается, пока снимок жив. Освобождение заменен-
+// ных версий и участков - по эпохам: снимок отмечает в своей ячейке эпоху
+// начала чтения, версия, снятая с публикации в эпоху r, удаляется, когда
+// во всех занятых ячейках эпоха больше r.
+class TConcurrentSet
+{
+private:
+  struct TVersion                 // опубликованная версия
+  {
+    std::vector<const TELEM*> Chunks;
+  };
+  struct TRetired                 // снятая с публикации версия
+  {
+    unsigned long long Epoch;     // эпоха снятия
+    const TVersion *pVersion;
+    std::vector<const TELEM*> Chunks; // участки, замененные копиями
+  };
+  struct alignas(CacheLineSize) TReaderSlot // ячейка читателя
+  {
+    std::atomic<unsigned long long> Epoch; // 0 - свободна
+  };
+
+  int MaxPower;                        // мощность универса
+  int ChunkMemLen;                     // к-во эл-тов в участке
+  std::atomic<const TVersion*> pCurrent; // текущая версия
+  std::atomic<unsigned long long> Epoch; // глобальная эпоха
+  TReaderSlot Slots[ConcurrentMaxReaders];
+
+  // черновик писателя
+  std::vector<TELEM*> Pending;         // участки черновика
+  std::vector<char> Dirty;             // участок уже скопирован
+  std::vector<int> DirtyChunks;        // номера скопированных участков
+  std::vector<const TELEM*> Replaced;  // участки текущей версии, замененные копиями
+  std::vector<TRetired> Retired;       // ожидают освобождения
+
+  void Init(const TBitField &bf);      // первая версия
+  TELEM* WritableChunk(const int ElemIndex); // участок черновика для изменения
+  void Free(const TVersion *pVersion, const std::vector<const TELEM*> &chunks);
+public:
+  class TSnapshot
+  {
+  private:
+    TConcurrentSet *pSet;
+    int Slot;
+    const TVersion *pVersion;
+  public:
+    TSnapshot(TConcurrentSet &s);
+    TSnapshot(TSnapshot &&s);
+    TSnapshot(const TSnapshot &) = delete;
+    TSnapshot& operator=(const TSnapshot &) = delete;
+    ~TSnapshot();
+
+    int GetMaxPower(void) const;             // максимальная мощность множества
+    int IsMember(const int ElemIndex) const; // проверить наличие элемента
+    TSet ToSet(void) const;                  // копия версии
+  };
+
+  TConcurrentSet(int mp);
+  TConcurrentSet(const TSet &s);
+  TConcurrentSet(const TConcurrentSet &) = delete;
+  TConcurrentSet& operator=(const TConcurrentSet &) = delete;
+  ~TConcurrentSet(); // снимков к этому моменту быть не должно
+
+  int GetMaxPower(void) const; // максимальная мощность множества
+  TSnapshot Snapshot(void);    // снимок текущей версии (любой поток)
+
+  // только поток-писатель; изменения видны читателям после Publish
+  void InsElem(const int ElemIndex); // включить элемент в черновик
+  void DelElem(const int ElemIndex); // удалить элемент из черновика
+  void Publish(void);                // опубликовать черновик
+  int  Reclaim(void);                // освободить ненужные версии, вернуть к-во ожидающих
+};
+
+#endif
@@ -0,0 +1,49 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tfactortable.h
+//
+// Таблица наименьших простых делителей и разложение на множители
+
+#ifndef __FACTORTABLE_H__
+#define __FACTORTABLE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Результат пакетного разложения: множители всех чисел подряд и границы
+// разложения каждого числа. При повторном использовании память не
+// перераспределяется, если объем результата не вырос.
+class TFactorization
+{
+private:
+  std::vector<std::uint32_t> Factors;  // множители по неубыванию, числа подряд
+  std::vector<std::size_t> Offsets;    // начало разложения i-го числа, и конец последнего
+  friend class TFactorTable;
+public:
+  std::size_t GetCount(void) const;                 // к-во разложенных чисел
+  std::size_t GetFactorCount(std::size_t i) const;  // к-во множителей i-го числа
+  const std::uint32_t* GetFactors(std::size_t i) const; // множители i-го числа
+};
+
+// Наименьшие простые делители (НПД) строятся линейным решетом. Хранятся
+// только нечетные числа; для простых хранится 0, для составных n НПД не
+// больше sqrt(n) < 2^16, поэтому хватает 16 бит на число.
+class TFactorTable
+{
+private:
+  std::uint32_t Limit;               // верхняя граница таблицы
+  std::vector<std::uint16_t> Spf;    // НПД нечетного числа 2i+1, 0 - простое
+public:
+  TFactorTable(std::uint32_t limit);
+
+  std::uint32_t GetLimit(void) const;                 // верхняя граница
+  bool IsPrime(std::uint32_t n) const;                // n - простое
+  std::uint32_t SmallestFactor(std::uint32_t n) const;// НПД числа n >= 2
+  // разложение одного числа; множители дописываются в factors
+  void Factorize(std::uint32_t n, std::vector<std::uint32_t> &factors) const;
+  // пакетное разложение count чисел
+  void Factorize(const std::uint32_t *values, std::size_t count, TFactorization &res) const;
+};
+
+#endif
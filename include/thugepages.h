@@ -0,0 +1,68 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// thugepages.h
+//
+// Ресурс памяти на больших (2 Мбайт) страницах для больших битовых полей
+
+#ifndef __HUGEPAGES_H__
+#define __HUGEPAGES_H__
+
+#include <cstddef>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+
+const std::size_t HugePageSize = std::size_t(2) << 20; // размер большой страницы
+
+// Статистика ресурса; байты на больших страницах считаются по
+// /proc/self/smaps для еще не освобожденных участков, причем прозрачные
+// большие страницы появляются только у затронутой памяти
+struct THugePageStats
+{
+  long long MappedCount;    // к-во участков, выделенных через mmap
+  long long MappedBytes;    // их суммарный размер
+  long long AdvisedBytes;   // из них помечено madvise(MADV_HUGEPAGE)
+  long long HugeTLBBytes;   // из них выделено из hugetlbfs (MAP_HUGETLB)
+  long long HugeBytes;      // фактически на больших страницах сейчас
+  long long UpstreamCount;  // к-во выделений, переданных вышестоящему ресурсу
+};
+
+// Выделения не меньше Threshold байт получают отдельный участок mmap,
+// выровненный на HugePageSize: из hugetlbfs, если это разрешено и там
+// есть страницы, иначе обычная память с madvise(MADV_HUGEPAGE) для
+// прозрачных больших страниц. Меньшие выделения и системы без mmap
+// (Windows: большие страницы там требуют привилегии SeLockMemoryPrivilege)
+// обслуживает вышестоящий ресурс.
+//   THugePageResource huge;
+//   TBitField bf(1 << 30, &huge);
+class THugePageResource : public std::pmr::memory_resource
+{
+private:
+  struct TRegion
+  {
+    std::size_t Size; // размер участка
+    bool HugeTLB;     // участок из hugetlbfs
+  };
+
+  std::pmr::memory_resource *pUpstream; // ресурс для малых выделений
+  std::size_t Threshold;                // наименьшее выделение через mmap
+  bool UseHugeTLB;                      // пробовать MAP_HUGETLB
+  mutable std::mutex Lock;
+  std::map<char*, TRegion> Regions;     // живые участки mmap
+  THugePageStats Stats;
+
+  void* do_allocate(std::size_t bytes, std::size_t align) override;
+  void do_deallocate(void *p, std::size_t bytes, std::size_t align) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+public:
+  THugePageResource(std::size_t threshold = HugePageSize, bool hugeTLB = false,
+                    std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+  THugePageResource(const THugePageResource &) = delete;
+  THugePageResource& operator=(const THugePageResource &) = delete;
+  ~THugePageResource();
+
+  std::size_t GetThreshold(void) const; // наименьшее выделение через mmap
+  THugePageStats GetStats(void) const;  // статистика выделений
+};
+
+#endif
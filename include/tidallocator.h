@@ -0,0 +1,42 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tidallocator.h
+//
+// Выдача и возврат номеров (идентификаторов) без блокировок
+
+#ifndef __IDALLOCATOR_H__
+#define __IDALLOCATOR_H__
+
+#include "tatomicbitfield.h"
+
+// Занятые номера - единичные биты TAtomicBitField. Свободный бит ищется
+// в эл-те и занимается сравнением с заменой всего эл-та; поиск начинается
+// с эл-та, на котором поток занял номер в этом распределителе в прошлый
+// раз, поэтому разные потоки обычно работают с разными строками кэша
+// (поток помнит эл-ты для нескольких распределителей). Сводка - по биту на
+// эл-т, 1 - эл-т заполнен; заполненные эл-ты пропускаются по 32 сразу.
+// Сводка - только подсказка: если по ней свободных номеров нет, эл-ты
+// просматриваются еще раз без нее.
+class TIdAllocator
+{
+private:
+  TAtomicBitField Bits;    // занятые номера
+  TAtomicBitField Summary; // заполненные эл-ты Bits
+  int WordCount;           // к-во используемых эл-тов Bits
+
+  TELEM WordMask(const int w) const;  // допустимые биты эл-та w
+  void  MarkFull(const int w);        // отметить заполненный эл-т в сводке
+  int   AcquireInWord(const int w, int count, int *ids); // занять до count номеров в эл-те w
+public:
+  TIdAllocator(int len);
+  TIdAllocator(const TIdAllocator &) = delete;
+  TIdAllocator& operator=(const TIdAllocator &) = delete;
+
+  int  GetLength(void) const;           // к-во номеров
+  int  IsAcquired(const int id) const;  // номер занят?
+  int  Acquire(void);                   // занять номер, -1 - свободных нет
+  int  AcquireN(int count, int *ids);   // занять до count номеров, вернуть к-во занятых
+  void Release(const int id);           // вернуть номер
+};
+
+#endif
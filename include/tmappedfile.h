@@ -0,0 +1,31 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tmappedfile.h
+//
+// Файл, отображенный в память только для чтения
+
+#ifndef __MAPPEDFILE_H__
+#define __MAPPEDFILE_H__
+
+#include <cstddef>
+
+class TMappedFile
+{
+private:
+  const char *pData; // начало отображения
+  std::size_t Size;  // размер файла
+#ifdef _WIN32
+  void *hFile;       // дескрипторы файла и отображения
+  void *hMapping;
+#endif
+public:
+  TMappedFile(const char *path);
+  TMappedFile(const TMappedFile &) = delete;
+  TMappedFile& operator=(const TMappedFile &) = delete;
+  ~TMappedFile();
+
+  const char* GetData(void) const; // содержимое файла
+  std::size_t GetSize(void) const; // размер файла
+};
+
+#endif
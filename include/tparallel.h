@@ -0,0 +1,73 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tparallel.h
+//
+// Параллельное выполнение независимых заданий
+
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// к-во потоков: threads <= 0 - по числу ядер
+inline int GetThreadCount(int threads)
+{
+  if (threads > 0)
+    return threads;
+
+  const unsigned hw = std::thread::hardware_concurrency();
+  return hw > 0 ? int(hw) : 1;
+}
+
+// f(i) для каждого i из [0, count); потоки разбирают номера заданий через
+// общий счетчик, вызывающий поток тоже участвует. Первое исключение из f
+// передается вызывающему после завершения всех потоков.
+template <typename F>
+void ParallelFor(long long count, int threads, F f)
+{
+  threads = GetThreadCount(threads);
+  if (threads > count)
+    threads = int(count);
+
+  if (threads <= 1)
+  {
+    for (long long i = 0; i < count; i++)
+      f(i);
+    return;
+  }
+
+  std::atomic<long long> nextTask(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]()
+  {
+    try
+    {
+      for (long long i = nextTask++; i < count; i = nextTask++)
+        f(i);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error)
+        error = std::current_exception();
+      nextTask = count;
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (int t = 1; t < threads; t++)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &th : pool)
+    th.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+#endif
@@ -0,0 +1,85 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tprimeset.h
+//
+// Множество простых чисел с ленивым расширением границы
+
+#ifndef __PRIMESET_H__
+#define __PRIMESET_H__
+
+#include "tbitfield.h"
+#include "tbitops.h"
+#include "tmappedfile.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// Хранятся только нечетные числа (бит i - число 2i+1). Для подсчета
+// простых на каждый блок из PrimeBlockLen битов хранится к-во единиц до
+// начала блока. Если запрос выходит за границу, граница увеличивается
+// (не менее чем вдвое), уже просеянная часть копируется без пересчета.
+//
+// Просеянное множество можно сохранить в файл (граница, контрольная сумма,
+// биты и префиксные суммы) и затем отобразить его в память только для
+// чтения: процессы, открывшие один файл, делят одну копию в кэше страниц.
+// При расширении границы отображенное множество копируется в свою память.
+
+const int PrimeBlockLen = 512; // длина блока таблицы префиксных сумм в битах
+
+class TPrimeSet
+{
+private:
+  TBitField Bits;               // нечетные простые
+  std::vector<long long> Prefix;// к-во единиц до начала каждого блока и всего
+  std::unique_ptr<TMappedFile> pMapping; // отображенный файл, если множество открыто из него
+  TBitFieldView Words;          // действующие биты: Bits или данные файла
+  const long long *pPrefix;     // действующие префиксные суммы
+
+  void Extend(long long n);     // обеспечить покрытие чисел до n включительно
+  void Reserve(long long bits); // увеличить к-во битов, досеять новую часть
+public:
+  TPrimeSet(long long limit = 0);
+  TPrimeSet(const TPrimeSet &) = delete;
+  TPrimeSet& operator=(const TPrimeSet &) = delete;
+
+  void Save(const char *path) const;            // сохранить просеянное множество
+  void Open(const char *path, bool verify = true); // отобразить сохраненное множество
+  bool IsMapped(void) const;                    // данные в отображенном файле
+
+  long long GetLimit(void) const;       // все числа до границы уже просеяны
+  bool IsPrime(long long n);            // n - простое
+  long long PrimePi(long long n);       // к-во простых, не превосходящих n
+  long long NthPrime(long long k);      // k-е простое, k >= 1
+  long long NextPrime(long long n);     // наименьшее простое, большее n
+  long long PrevPrime(long long n);     // наибольшее простое, меньшее n
+  // f(p) для простых p из [from, to] по возрастанию
+  template <typename F> void ForEachPrime(long long from, long long to, F f);
+  std::vector<long long> GetPrimes(long long from, long long to); // простые из [from, to]
+};
+
+template <typename F>
+void TPrimeSet::ForEachPrime(long long from, long long to, F f)
+{
+  if (to < 2 || from > to)
+    return;
+  this->Extend(to);
+
+  if (from <= 2)
+    f(2ll);
+
+  const long long first = std::max(from, 0ll) / 2, last = (to + 1) / 2; // биты [first, last)
+  const TELEM *mem = this->Words.GetMem();
+  for (long long w = first / TELEMBits; w * TELEMBits < last; w++)
+  {
+    TELEM word = mem[w];
+    if (w == first / TELEMBits)
+      word &= TELEM(-1) << (first % TELEMBits);
+    if ((w + 1) * TELEMBits > last)
+      word &= TELEM(-1) >> ((w + 1) * TELEMBits - last);
+
+    for (; word != 0; word &= word - 1)
+      f(2 * (w * TELEMBits + _ctz(word)) + 1);
+  }
+}
+
+#endif
@@ -16,10 +16,13 @@ private:
   int MaxPower;       // максимальная мощность множества
   TBitField BitField; // битовое поле для хранения характеристического вектора
 public:
-  TSet(int mp);
+  TSet(int mp, std::pmr::memory_resource *mr = std::pmr::get_default_resource());
   TSet(const TSet &s);       // конструктор копирования
+  TSet(const TSet &s, std::pmr::memory_resource *mr); // копия в памяти из mr
   TSet(const TBitField &bf); // конструктор преобразования типа
   explicit operator TBitField();      // преобразование типа к битовому полю
+  const TBitField& GetBitField(void) const; // характеристический вектор (только чтение)
+  std::pmr::memory_resource* GetResource(void) const; // откуда выделена память
   // доступ к битам
   int GetMaxPower(void) const;     // максимальная мощность множества
   void InsElem(const int ElemIndex);       // включить элемент с указанным индексом в множество
@@ -39,5 +42,10 @@ public:
 
   friend istream &operator>>(istream &istr, TSet &bf);
   friend ostream &operator<<(ostream &ostr, const TSet &bf);
+
+  // двоичный формат: плотный (битовое поле) или разреженный (разности
+  // соседних элементов в кодировке stream-vbyte), выбирается по мощности
+  void Save(ostream &ostr) const;
+  void Load(istream &istr);
 };
 #endif
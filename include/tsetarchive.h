@@ -0,0 +1,61 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tsetarchive.h
+//
+// Архив множеств с таблицей смещений для произвольного доступа
+
+#ifndef __SETARCHIVE_H__
+#define __SETARCHIVE_H__
+
+#include "tbitfield.h"
+#include "tmappedfile.h"
+#include <fstream>
+#include <memory>
+#include <vector>
+
+// Структура файла:
+//   заголовок - сигнатура, версия, к-во записей, смещение таблицы;
+//   записи - битовые поля в формате TBitField::Save, выровненные на 8 байт;
+//   таблица - (id, смещение, размер) для каждой записи, упорядочена по id.
+
+struct TSetArchiveEntry
+{
+  unsigned long long Id;     // идентификатор множества
+  unsigned long long Offset; // смещение записи от начала файла
+  unsigned long long Size;   // размер записи в байтах
+};
+
+class TSetArchiveWriter
+{
+private:
+  std::ofstream File;
+  std::vector<TSetArchiveEntry> Table;
+  bool Closed;
+public:
+  TSetArchiveWriter(const char *path);
+  TSetArchiveWriter(const TSetArchiveWriter &) = delete;
+  ~TSetArchiveWriter();
+
+  void Add(unsigned long long id, const TBitField &bf); // добавить запись
+  void Close(void);                                     // записать таблицу и заголовок
+};
+
+class TSetArchiveReader
+{
+private:
+  std::string Path;
+  std::ifstream File;
+  std::vector<TSetArchiveEntry> Table;
+  std::unique_ptr<TMappedFile> pMapping; // создается при первом Map
+
+  const TSetArchiveEntry& Find(unsigned long long id) const;
+public:
+  TSetArchiveReader(const char *path);
+
+  int  GetCount(void) const;                   // к-во записей
+  bool Contains(unsigned long long id) const;  // есть ли запись с id
+  TBitField Load(unsigned long long id);       // прочитать только эту запись
+  TBitFieldView Map(unsigned long long id);    // запись в отображенном файле
+};
+
+#endif
@@ -0,0 +1,158 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tsieve.h
+//
+// Сегментированное решето Эратосфена на битовых полях
+
+#ifndef __SIEVE_H__
+#define __SIEVE_H__
+
+#include "tbitfield.h"
+#include "tbitops.h"
+#include "tparallel.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+const int SieveSegmentLen = 8 * 32768; // окно по умолчанию - 32 Кбайт (кэш L1)
+
+// Колесо: в битовом поле хранятся только числа, взаимно простые с модулем
+//   WheelNone - все числа, бит i - число i
+//   WheelOdd  - нечетные числа, бит i - число 2i+1
+//   Wheel30   - вычеты 1,7,11,13,17,19,23,29 по модулю 30, 8 бит на 30 чисел
+enum TSieveWheel { WheelNone, WheelOdd, Wheel30 };
+
+class TWheel
+{
+private:
+  int Modulus;      // модуль колеса
+  int Count;        // к-во вычетов, взаимно простых с модулем
+  int Residues[8];  // эти вычеты по возрастанию
+  int Below[31];    // к-во вычетов, меньших r
+  TWheel(int modulus, const int *residues, int count);
+public:
+  static const TWheel& Get(TSieveWheel wheel);
+
+  int GetModulus(void) const;           // модуль колеса
+  int GetCount(void) const;             // к-во битов на модуль
+  int GetResidue(int j) const;          // j-й вычет
+  bool Contains(long long n) const;     // хранится ли число n
+  long long IndexOf(long long n) const; // номер бита числа n (или следующего хранимого)
+  long long ValueOf(long long i) const; // число, хранимое в бите i
+};
+
+// Кратные малых простых 2..13, не делящих модуль колеса, вычеркиваются
+// не по одному: их общий узор повторяется каждые 30030 бит (15015 для
+// WheelOdd, 8008 для Wheel30), он строится один раз и копируется в окна
+// целыми словами.
+const int SievePatternPrimes[] = { 2, 3, 5, 7, 11, 13 };
+
+// Отрезок [0, Limit] просеивается окнами по SegmentLen бит. Для каждого
+// простого до sqrt(Limit) хранятся следующие кратные (по одному на вычет
+// колеса), которые переносятся из окна в окно, поэтому память -
+// O(sqrt(Limit)) плюс одно окно.
+class TSegmentedSieve
+{
+private:
+  long long Limit;             // верхняя граница просеивания
+  long long IndexEnd;          // к-во хранимых чисел в [0, Limit]
+  int  SegmentLen;             // длина окна в битах (кратна длине TELEM)
+  const TWheel &Wheel;         // представление чисел в окнах
+  std::vector<int> Primes;     // простые до sqrt(Limit)
+  int  FirstCrossed;           // номер в Primes первого простого, не делящего модуль
+  int  FirstSieved;            // номер в Primes первого простого после предпросеянных
+  std::vector<TELEM> Pattern;  // повторяющийся узор предпросеивания (см. PreSieve)
+  std::vector<int> PatternPrimes; // простые, вычеркнутые узором
+
+  void BuildPattern(void);     // построить узор предпросеивания
+  void PreSieve(long long low, TBitField &window) const; // заполнить окно узором
+
+  void InitOffsets(long long low, std::vector<long long> &next) const; // первые кратные от бита low
+  void CrossOff(long long low, TBitField &window, std::vector<long long> &next) const; // просеять окно
+public:
+  TSegmentedSieve(long long limit, int segmentLen = SieveSegmentLen, TSieveWheel wheel = WheelNone);
+
+  long long GetLimit(void) const;   // верхняя граница
+  long long GetIndexEnd(void) const;// к-во битов во всех окнах
+  int GetSegmentLen(void) const;    // длина окна
+  const TWheel& GetWheel(void) const; // представление чисел в окнах
+  const std::vector<int>& GetBasePrimes(void) const; // простые до sqrt(Limit)
+
+  // f(low, window): бит i окна установлен, если число GetWheel().ValueOf(low + i) простое;
+  // простые, делящие модуль колеса, в окнах не представлены
+  template <typename F> void ForEachSegment(F f) const;
+  // то же для битов [from, to) - окна идут подряд от from, смещения переносятся
+  template <typename F> void ForEachSegment(long long from, long long to, F f) const;
+  // f(p) для каждого простого p <= Limit в порядке возрастания
+  template <typename F> void ForEachPrime(F f) const;
+  long long Count(void) const;      // к-во простых до Limit
+
+  // параллельное просеивание: отрезок делится на участки из нескольких окон,
+  // участки разбираются потоками, у каждого потока свои окна и смещения;
+  // threads <= 0 - по числу ядер
+  long long GetWindowCount(void) const;  // к-во окон
+  // f(low, window) вызывается из разных потоков, порядок окон не определен
+  template <typename F> void ForEachSegment(F f, int threads) const;
+  long long Count(int threads) const;             // к-во простых до Limit
+  std::vector<long long> GetPrimes(int threads = 1) const; // все простые до Limit по возрастанию
+};
+
+template <typename F>
+void TSegmentedSieve::ForEachSegment(long long from, long long to, F f) const
+{
+  if (from < 0 || from > to || to > this->IndexEnd)
+    throw std::out_of_range("invalid sieve range");
+
+  std::vector<long long> next;
+  this->InitOffsets(from, next);
+
+  TBitField window(int(std::min<long long>(this->SegmentLen, to - from)));
+  for (long long low = from; low < to; low += this->SegmentLen)
+  {
+    if (to - low < window.GetLength())
+      window = TBitField(int(to - low));
+
+    this->CrossOff(low, window, next);
+    f(low, static_cast<const TBitField &>(window));
+  }
+}
+
+template <typename F>
+void TSegmentedSieve::ForEachSegment(F f) const
+{
+  this->ForEachSegment(0, this->IndexEnd, f);
+}
+
+template <typename F>
+void TSegmentedSieve::ForEachSegment(F f, int threads) const
+{
+  // по несколько участков на поток - для выравнивания нагрузки
+  const long long windows = this->GetWindowCount();
+  const long long parts = std::min<long long>(windows, 8ll * GetThreadCount(threads));
+  ParallelFor(parts, threads, [&](long long part)
+  {
+    const long long from = windows * part / parts * this->SegmentLen;
+    const long long to = std::min(windows * (part + 1) / parts * this->SegmentLen, this->IndexEnd);
+    this->ForEachSegment(from, to, f);
+  });
+}
+
+template <typename F>
+void TSegmentedSieve::ForEachPrime(F f) const
+{
+  for (int i = 0; i < this->FirstCrossed; i++)
+    if (this->Primes[i] <= this->Limit)
+      f((long long)this->Primes[i]);
+
+  const TWheel &wheel = this->Wheel;
+  this->ForEachSegment([&f, &wheel](long long low, const TBitField &window)
+  {
+    const TELEM *mem = window.GetMem();
+    for (int i = 0; i < window.GetMemLen(); i++)
+      for (TELEM word = mem[i]; word != 0; word &= word - 1)
+        f(wheel.ValueOf(low + (long long)i * TELEMBits + _ctz(word)));
+  });
+}
+
+#endif
@@ -0,0 +1,82 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tvarint.h
+//
+// Кодирование целых переменной длины в блочной раскладке stream-vbyte
+
+#ifndef __VARINT_H__
+#define __VARINT_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// Каждые 4 значения описываются управляющим байтом (по 2 бита на значение:
+// длина в байтах - 1), управляющие байты блока хранятся отдельно от байтов
+// данных. Длины всех значений блока известны до разбора данных, поэтому
+// декодирование не ветвится на каждом байте.
+
+// размер управляющей части для count значений
+inline std::size_t StreamVByteControlLen(std::size_t count)
+{
+  return (count + 3) / 4;
+}
+
+// наибольший размер данных для count значений
+inline std::size_t StreamVByteMaxDataLen(std::size_t count)
+{
+  return 4 * count;
+}
+
+// кодирование; возвращает к-во записанных байтов данных
+inline std::size_t StreamVByteEncode(const std::uint32_t *in, std::size_t count,
+                                     std::uint8_t *control, std::uint8_t *data)
+{
+  std::uint8_t *pos = data;
+  for (std::size_t i = 0; i < count; i++)
+  {
+    const std::uint32_t val = in[i];
+    const unsigned code = (val > 0xFF) + (val > 0xFFFF) + (val > 0xFFFFFF);
+
+    if (i % 4 == 0)
+      control[i / 4] = 0;
+    control[i / 4] |= std::uint8_t(code << (2 * (i % 4)));
+
+    for (unsigned b = 0; b <= code; b++)
+      *pos++ = std::uint8_t(val >> (8 * b));
+  }
+
+  return std::size_t(pos - data);
+}
+
+// размер данных, описанных управляющей частью
+inline std::size_t StreamVByteDataLen(const std::uint8_t *control, std::size_t count)
+{
+  std::size_t len = count;
+  for (std::size_t i = 0; i < count; i++)
+    len += (control[i / 4] >> (2 * (i % 4))) & 3;
+
+  return len;
+}
+
+// декодирование; каждое значение передается в f
+template <typename F>
+inline const std::uint8_t* StreamVByteDecode(const std::uint8_t *control, const std::uint8_t *data,
+                                             std::size_t count, F f)
+{
+  for (std::size_t i = 0; i < count; i++)
+  {
+    const unsigned code = (control[i / 4] >> (2 * (i % 4))) & 3;
+
+    std::uint32_t val = data[0];
+    if (code > 0) val |= std::uint32_t(data[1]) << 8;
+    if (code > 1) val |= std::uint32_t(data[2]) << 16;
+    if (code > 2) val |= std::uint32_t(data[3]) << 24;
+    data += code + 1;
+
+    f(val);
+  }
+
+  return data;
+}
+
+#endif
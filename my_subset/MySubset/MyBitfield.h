@@ -6,61 +6,95 @@
 #include <initializer_list>
 #include <stdexcept>
 #include <iterator>
+#include <cstring>
+#include <bit>
+#include <algorithm>
 
 
+// Storage of any T is processed as 64-bit lanes: memcpy keeps the access
+// well-defined for every T and compiles to plain (vectorizable) loads.
+template <typename Op>
+inline void _bitfield_lanes(void* dst, const void* src, std::size_t bytes, Op op) noexcept
+{
+	auto d = static_cast<unsigned char*>(dst);
+	auto s = static_cast<const unsigned char*>(src);
+
+	std::size_t i = 0;
+	for (; i + sizeof(std::uint64_t) <= bytes; i += sizeof(std::uint64_t))
+	{
+		std::uint64_t a, b;
+		std::memcpy(&a, d + i, sizeof(a));
+		std::memcpy(&b, s + i, sizeof(b));
+		a = op(a, b);
+		std::memcpy(d + i, &a, sizeof(a));
+	}
+	for (; i < bytes; i++)
+	{
+		d[i] = static_cast<unsigned char>(op(std::uint64_t(d[i]), std::uint64_t(s[i])));
+	}
+}
+
 template <typename T, std::enable_if_t<std::is_unsigned_v<T>, int> = 0>
 struct _bitfield_container
 {
 	_bitfield_container() = default;
 	_bitfield_container(std::size_t sz)
 		: _size(sz)
+		, _capacity(_bit_to_size(sz))
 		, _data(new T[_bit_to_size(sz)]{})
 	{}
 	_bitfield_container(const _bitfield_container& other)
 		: _size(other._size)
+		, _capacity(_bit_to_size(other._size))
 		, _data(new T[_bit_to_size(other._size)]{})
 	{
-		for (std::size_t i = 0; i < _bit_to_size(this->_size); i++)
-		{
-			this->_data[i] = other._data[i];
+		if (this->_size > 0) {
+			std::memcpy(this->_data, other._data, this->_byte_size());
 		}
 	}
 	_bitfield_container(_bitfield_container&& other) noexcept
 		: _size(other._size)
+		, _capacity(other._capacity)
 		, _data(other._data)
 	{
 		other._data = nullptr;
 		other._size = 0;
+		other._capacity = 0;
 	}
 
 	_bitfield_container& operator=(const _bitfield_container& right)
 	{
-		if (*this == &right) return *this;
+		if (this == &right) return *this;
 
-		if (_bit_to_size(this->_size) != _bit_to_size(right._size)) {
+		if (this->_capacity < _bit_to_size(right._size)) {
 			this->clear();
-			this->_data = new T[_bit_to_size(right._size)];
+			this->_data = new T[_bit_to_size(right._size)]{};
+			this->_capacity = _bit_to_size(right._size);
+		}
+		else {
+			this->resize(0);
 		}
 
 		this->_size = right._size;
 
-		for (std::size_t i = 0; i < _bit_to_size(this->_size); i++)
-		{
-			this->_data[i] = right._data[i];
+		if (this->_size > 0) {
+			std::memcpy(this->_data, right._data, this->_byte_size());
 		}
 
 		return *this;
 	}
 	_bitfield_container& operator=(_bitfield_container&& right) noexcept
 	{
-		if (*this == &right) return *this;
+		if (this == &right) return *this;
 
 		this->clear();
 
 		this->_data = right._data;
 		this->_size = right._size;
+		this->_capacity = right._capacity;
 		right._data = nullptr;
 		right._size = 0;
+		right._capacity = 0;
 
 		return *this;
 	}
@@ -75,6 +109,7 @@ struct _bitfield_container
 		delete[] this->_data;
 		this->_data = nullptr;
 		this->_size = 0;
+		this->_capacity = 0;
 	}
 
 	size_t size() const noexcept
@@ -83,20 +118,18 @@ struct _bitfield_container
 	}
 	size_t capacity() const noexcept
 	{
-		return this->_bit_to_size(this->_size);
+		return this->_capacity;
 	}
 
+	// words past size() up to capacity() are kept zero, so growing
+	// within the capacity needs no work
 	void resize(size_t nsize)
 	{
-		if (_bit_to_size(this->_size) != _bit_to_size(nsize)) {
-			auto temp = new T[_bit_to_size(nsize)]{};
-			for (size_t i = 0; i < _bit_to_size(nsize) && i < _bit_to_size(this->_size); i++)
-			{
-				temp[i] = this->_data[i];
-			}
-
-			this->clear();
-			this->_data = temp;
+		if (_bit_to_size(nsize) > this->_capacity) {
+			this->_reallocate(std::max(_bit_to_size(nsize), 2 * this->_capacity));
+		}
+		else if (nsize < this->_size) {
+			std::fill(this->_data + _bit_to_size(nsize), this->_data + _bit_to_size(this->_size), T(0));
 		}
 
 		this->_size = nsize;
@@ -105,11 +138,88 @@ struct _bitfield_container
 			_use_mask_to_last_elem(this->_data[_bit_to_size(nsize) - 1], nsize);
 		}
 	}
+	void reserve(size_t count_bit)
+	{
+		if (_bit_to_size(count_bit) > this->_capacity) {
+			this->_reallocate(_bit_to_size(count_bit));
+		}
+	}
+	void shrink_to_fit()
+	{
+		if (_bit_to_size(this->_size) < this->_capacity) {
+			this->_reallocate(_bit_to_size(this->_size));
+		}
+	}
+	void push_back(bool value)
+	{
+		if (this->_size == this->_capacity * elem_size) {
+			this->_reallocate(std::max<size_t>(1, 2 * this->_capacity));
+		}
+
+		this->_data[this->_size / elem_size] |= T(value) << (this->_size % elem_size);
+		this->_size++;
+	}
+	// appends the low count_bit bits of word, size() must be a multiple of elem_size
+	void _append_word(T word, size_t count_bit)
+	{
+		if (this->_size == this->_capacity * elem_size) {
+			this->_reallocate(std::max<size_t>(1, 2 * this->_capacity));
+		}
+
+		this->_data[this->_size / elem_size] = word;
+		this->_size += count_bit;
+		if (this->_size % elem_size != 0) {
+			_use_mask_to_last_elem(this->_data[this->_size / elem_size], this->_size);
+		}
+	}
+	void _reallocate(size_t ncapacity)
+	{
+		T* temp = ncapacity > 0 ? new T[ncapacity]{} : nullptr;
+		if (this->_size > 0) {
+			std::memcpy(temp, this->_data, this->_byte_size());
+		}
+
+		delete[] this->_data;
+		this->_data = temp;
+		this->_capacity = ncapacity;
+	}
+
+	// count_bit <= elem_size bits starting at pos, pos + count_bit <= size()
+	T _get_bits(size_t pos, size_t count_bit) const noexcept
+	{
+		const size_t elem = pos / elem_size, shift = pos % elem_size;
+		T bits = T(this->_data[elem] >> shift);
+		if (shift != 0 && shift + count_bit > elem_size) {
+			bits |= T(this->_data[elem + 1] << (elem_size - shift));
+		}
+
+		return bits & _low_mask(count_bit);
+	}
+	void _set_bits(size_t pos, size_t count_bit, T bits) noexcept
+	{
+		const size_t elem = pos / elem_size, shift = pos % elem_size;
+		const T mask = _low_mask(count_bit);
+		bits &= mask;
+
+		this->_data[elem] = T((this->_data[elem] & ~T(mask << shift)) | T(bits << shift));
+		if (shift != 0 && shift + count_bit > elem_size) {
+			const size_t back = elem_size - shift;
+			this->_data[elem + 1] = T((this->_data[elem + 1] & ~T(mask >> back)) | T(bits >> back));
+		}
+	}
+	constexpr static T _low_mask(size_t count_bit) noexcept
+	{
+		return count_bit >= elem_size ? T(-1) : T((T(1) << count_bit) - 1);
+	}
 
 	constexpr static size_t _bit_to_size(size_t count_bit) noexcept
 	{
 		return (count_bit + elem_size - 1) / elem_size;
 	}
+	size_t _byte_size() const noexcept
+	{
+		return _bit_to_size(this->_size) * sizeof(T);
+	}
 	
 	static void _use_mask_to_last_elem(T& val, size_t sz) noexcept
 	{
@@ -117,6 +227,7 @@ struct _bitfield_container
 	}
 
 	std::size_t _size = 0;
+	std::size_t _capacity = 0; // allocated words
 	T* _data = nullptr;
 
 	static const std::size_t elem_size = sizeof(T) * 8;
@@ -124,12 +235,18 @@ struct _bitfield_container
 
 template <typename T>
 struct _bitfield_proxy;
+template <typename T, bool Const>
+struct _bitfield_iterator;
+template <typename T>
+class _bitfield_set_bits;
 
-template <typename T = uint8_t, std::enable_if_t<std::is_unsigned_v<T>, int> = 0>
+template <typename T = uint64_t, std::enable_if_t<std::is_unsigned_v<T>, int> = 0>
 class bitfield
 {
 public:
 	using reference = _bitfield_proxy<T>;
+	using iterator = _bitfield_iterator<T, false>;
+	using const_iterator = _bitfield_iterator<T, true>;
 
 	bitfield() = default;
 	bitfield(size_t size) : _data(size) {}
@@ -163,10 +280,19 @@ public:
 	explicit bitfield(const bitfield<U>& other)
 		: _data(other.size())
 	{
-		for (size_t i = 0; i < this->size(); i++)
-		{
-			if (other.read_bit(i)) {
-				this->set_bit(i);
+		if constexpr (std::endian::native == std::endian::little) {
+			// bit i is bit i % 8 of byte i / 8 for any word type
+			if (this->size() > 0) {
+				std::memcpy(this->_data._data, other._data._data, std::min(this->_data._byte_size(), other._data._byte_size()));
+				this->_data.resize(this->size());
+			}
+		}
+		else {
+			for (size_t i = 0; i < this->size(); i++)
+			{
+				if (other.read_bit(i)) {
+					this->set_bit(i);
+				}
 			}
 		}
 	}
@@ -209,7 +335,65 @@ public:
 	}
 	bool operator[](size_t index) const noexcept
 	{
-		return this->_data.read_bit(index);
+		return this->read_bit(index);
+	}
+
+	iterator begin() noexcept
+	{
+		return iterator(this, 0);
+	}
+	iterator end() noexcept
+	{
+		return iterator(this, this->size());
+	}
+	const_iterator begin() const noexcept
+	{
+		return const_iterator(this, 0);
+	}
+	const_iterator end() const noexcept
+	{
+		return const_iterator(this, this->size());
+	}
+	const_iterator cbegin() const noexcept
+	{
+		return this->begin();
+	}
+	const_iterator cend() const noexcept
+	{
+		return this->end();
+	}
+	// indices of the set bits in increasing order
+	_bitfield_set_bits<T> set_bits() const noexcept
+	{
+		return _bitfield_set_bits<T>(this);
+	}
+
+	// word access for the algorithms below: count_bit <= word bits
+	T _read_bits(size_t pos, size_t count_bit) const noexcept
+	{
+		return this->_data._get_bits(pos, count_bit);
+	}
+	void _write_bits(size_t pos, size_t count_bit, T bits) noexcept
+	{
+		this->_data._set_bits(pos, count_bit, bits);
+	}
+	// first bit equal to value in [from, to), to if there is none
+	size_t _find_bit(size_t from, size_t to, bool value) const noexcept
+	{
+		const size_t word = _bitfield_container<T>::elem_size;
+		for (size_t pos = from; pos < to; pos += word)
+		{
+			const size_t count_bit = std::min(word, to - pos);
+			T bits = this->_read_bits(pos, count_bit);
+			if (!value) {
+				bits = T(~bits) & _bitfield_container<T>::_low_mask(count_bit);
+			}
+			if (bits != 0) {
+				return pos + std::countr_zero(bits);
+			}
+		}
+
+		return to;
 	}
 
 	void clear() noexcept
@@ -220,6 +404,18 @@ public:
 	{
 		this->_data.resize(nsize);
 	}
+	void reserve(size_t count_bit)
+	{
+		this->_data.reserve(count_bit);
+	}
+	void shrink_to_fit()
+	{
+		this->_data.shrink_to_fit();
+	}
+	void push_back(bool value)
+	{
+		this->_data.push_back(value);
+	}
 	size_t size() const noexcept
 	{
 		return this->_data.size();
@@ -233,13 +429,9 @@ public:
 	{
 		if (&left == &right) return true;
 		if (left._data._size != right._data._size) return false;
+		if (left._data._size == 0) return true;
 
-		for (size_t i = 0; i < _bitfield_container<T>::_bit_to_size(left._data._size); i++)
-		{
-			if (left._data._data[i] != right._data._data[i]) return false;
-		}
-
-		return true;
+		return std::memcmp(left._data._data, right._data._data, left._data._byte_size()) == 0;
 	}
 	friend bool operator!=(const bitfield& left, const bitfield& right)
 	{
@@ -247,6 +439,11 @@ public:
 	}
 
 protected:
+	template <typename U, std::enable_if_t<std::is_unsigned_v<U>, int>>
+	friend class bitfield;
+	template <typename U>
+	friend class bitfield_appender;
+
 	_bitfield_container<T> _data;
 
 	static size_t _get_elem_pos(size_t index)
@@ -259,6 +456,55 @@ protected:
 	}
 };
 
+// Appends bits to the end of a bitfield through a one-word buffer:
+// bits are collected in a register and stored a whole word at a time.
+// The bitfield is complete after flush() or destruction of the appender.
+template <typename T>
+class bitfield_appender
+{
+public:
+	bitfield_appender(bitfield<T>& field)
+		: field(field)
+	{}
+	bitfield_appender(const bitfield_appender&) = delete;
+	bitfield_appender& operator=(const bitfield_appender&) = delete;
+
+	~bitfield_appender()
+	{
+		this->flush();
+	}
+
+	void push_back(bool value)
+	{
+		if (this->field.size() % elem_size != 0) {
+			this->field.push_back(value); // until the bitfield is word-aligned
+			return;
+		}
+
+		this->buffer |= T(value) << this->count;
+		if (++this->count == elem_size) {
+			this->field._data._append_word(this->buffer, elem_size);
+			this->buffer = 0;
+			this->count = 0;
+		}
+	}
+	void flush()
+	{
+		if (this->count > 0) {
+			this->field._data._append_word(this->buffer, this->count);
+			this->buffer = 0;
+			this->count = 0;
+		}
+	}
+
+private:
+	static const std::size_t elem_size = _bitfield_container<T>::elem_size;
+
+	bitfield<T>& field;
+	T buffer = 0;
+	std::size_t count = 0;
+};
+
 template <typename T>
 struct _bitfield_proxy
 {
@@ -296,7 +542,7 @@ public:
 	bitfield<T>& field;
 };
 
-template <typename T = uint8_t, std::enable_if_t<std::is_unsigned_v<T>, int> = 0>
+template <typename T = uint64_t, std::enable_if_t<std::is_unsigned_v<T>, int> = 0>
 class bitfield_arithmetic : public bitfield<T>
 {
 public:
@@ -317,10 +563,8 @@ public:
 			throw std::logic_error("different lengths of arguments");
 		}
 
-		for (size_t i = 0; i < _bitfield_container<T>::_bit_to_size(this->_data._size); i++)
-		{
-			this->_data._data[i] &= right._data._data[i];
-		}
+		_bitfield_lanes(this->_data._data, right._data._data, this->_data._byte_size(),
+			[](std::uint64_t a, std::uint64_t b) { return a & b; });
 
 		return *this;
 	}
@@ -330,10 +574,8 @@ public:
 			throw std::logic_error("different lengths of arguments");
 		}
 
-		for (size_t i = 0; i < _bitfield_container<T>::_bit_to_size(this->_data._size); i++)
-		{
-			this->_data._data[i] |= right._data._data[i];
-		}
+		_bitfield_lanes(this->_data._data, right._data._data, this->_data._byte_size(),
+			[](std::uint64_t a, std::uint64_t b) { return a | b; });
 
 		return *this;
 	}
@@ -343,10 +585,8 @@ public:
 			throw std::logic_error("different lengths of arguments");
 		}
 
-		for (size_t i = 0; i < _bitfield_container<T>::_bit_to_size(this->_data._size); i++)
-		{
-			this->_data._data[i] ^= right._data._data[i];
-		}
+		_bitfield_lanes(this->_data._data, right._data._data, this->_data._byte_size(),
+			[](std::uint64_t a, std::uint64_t b) { return a ^ b; });
 
 		return *this;
 	}
@@ -356,10 +596,8 @@ public:
 			throw std::logic_error("different lengths of arguments");
 		}
 
-		for (size_t i = 0; i < _bitfield_container<T>::_bit_to_size(this->_data._size); i++)
-		{
-			this->_data._data[i] &= ~right._data._data[i];
-		}
+		_bitfield_lanes(this->_data._data, right._data._data, this->_data._byte_size(),
+			[](std::uint64_t a, std::uint64_t b) { return a & ~b; });
 
 		return *this;
 	}
@@ -387,10 +625,8 @@ public:
 	friend bitfield_arithmetic operator~(bitfield_arithmetic val)
 	{
 		if (val.capacity() > 0) {
-			for (size_t i = 0; i < val.capacity(); i++)
-			{
-				val._data._data[i] = ~val._data._data[i];
-			}
+			_bitfield_lanes(val._data._data, val._data._data, val._data._byte_size(),
+				[](std::uint64_t a, std::uint64_t) { return ~a; });
 			val.resize(val.size());
 		}
 
@@ -398,4 +634,248 @@ public:
 	}
 };
 
+// Random access iterator over the bits; dereferencing gives a proxy
+// (or bool for const_iterator), like vector<bool>::iterator.
+template <typename T, bool Const>
+struct _bitfield_iterator
+{
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = bool;
+	using difference_type = std::ptrdiff_t;
+	using pointer = void;
+	using reference = std::conditional_t<Const, bool, _bitfield_proxy<T>>;
+	using field_type = std::conditional_t<Const, const bitfield<T>, bitfield<T>>;
+
+	_bitfield_iterator() = default;
+	_bitfield_iterator(field_type* field, size_t index) noexcept
+		: field(field)
+		, index(index)
+	{}
+	template <bool OtherConst, std::enable_if_t<Const && !OtherConst, int> = 0>
+	_bitfield_iterator(const _bitfield_iterator<T, OtherConst>& other) noexcept
+		: field(other.field)
+		, index(other.index)
+	{}
+
+	reference operator*() const noexcept
+	{
+		if constexpr (Const) {
+			return this->field->read_bit(this->index);
+		}
+		else {
+			return _bitfield_proxy<T>(*this->field, this->index);
+		}
+	}
+	reference operator[](difference_type n) const noexcept
+	{
+		return *(*this + n);
+	}
+
+	_bitfield_iterator& operator++() noexcept
+	{
+		++this->index;
+		return *this;
+	}
+	_bitfield_iterator operator++(int) noexcept
+	{
+		auto temp = *this;
+		++this->index;
+		return temp;
+	}
+	_bitfield_iterator& operator--() noexcept
+	{
+		--this->index;
+		return *this;
+	}
+	_bitfield_iterator operator--(int) noexcept
+	{
+		auto temp = *this;
+		--this->index;
+		return temp;
+	}
+	_bitfield_iterator& operator+=(difference_type n) noexcept
+	{
+		this->index += n;
+		return *this;
+	}
+	_bitfield_iterator& operator-=(difference_type n) noexcept
+	{
+		this->index -= n;
+		return *this;
+	}
+
+	friend _bitfield_iterator operator+(_bitfield_iterator it, difference_type n) noexcept
+	{
+		return it += n;
+	}
+	friend _bitfield_iterator operator+(difference_type n, _bitfield_iterator it) noexcept
+	{
+		return it += n;
+	}
+	friend _bitfield_iterator operator-(_bitfield_iterator it, difference_type n) noexcept
+	{
+		return it -= n;
+	}
+	friend difference_type operator-(const _bitfield_iterator& left, const _bitfield_iterator& right) noexcept
+	{
+		return difference_type(left.index) - difference_type(right.index);
+	}
+
+	friend bool operator==(const _bitfield_iterator& left, const _bitfield_iterator& right) noexcept
+	{
+		return left.index == right.index;
+	}
+	friend bool operator!=(const _bitfield_iterator& left, const _bitfield_iterator& right) noexcept
+	{
+		return left.index != right.index;
+	}
+	friend bool operator<(const _bitfield_iterator& left, const _bitfield_iterator& right) noexcept
+	{
+		return left.index < right.index;
+	}
+	friend bool operator>(const _bitfield_iterator& left, const _bitfield_iterator& right) noexcept
+	{
+		return left.index > right.index;
+	}
+	friend bool operator<=(const _bitfield_iterator& left, const _bitfield_iterator& right) noexcept
+	{
+		return left.index <= right.index;
+	}
+	friend bool operator>=(const _bitfield_iterator& left, const _bitfield_iterator& right) noexcept
+	{
+		return left.index >= right.index;
+	}
+
+	field_type* field = nullptr;
+	size_t index = 0;
+};
+
+// Forward iterator over the indices of the set bits, skips zero words with ctz
+template <typename T>
+struct _bitfield_set_bit_iterator
+{
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const size_t*;
+	using reference = size_t;
+
+	_bitfield_set_bit_iterator() = default;
+	_bitfield_set_bit_iterator(const bitfield<T>* field, size_t index) noexcept
+		: field(field)
+		, index(field->_find_bit(index, field->size(), true))
+	{}
+
+	size_t operator*() const noexcept
+	{
+		return this->index;
+	}
+
+	_bitfield_set_bit_iterator& operator++() noexcept
+	{
+		this->index = this->field->_find_bit(this->index + 1, this->field->size(), true);
+		return *this;
+	}
+	_bitfield_set_bit_iterator operator++(int) noexcept
+	{
+		auto temp = *this;
+		++(*this);
+		return temp;
+	}
+
+	friend bool operator==(const _bitfield_set_bit_iterator& left, const _bitfield_set_bit_iterator& right) noexcept
+	{
+		return left.index == right.index;
+	}
+	friend bool operator!=(const _bitfield_set_bit_iterator& left, const _bitfield_set_bit_iterator& right) noexcept
+	{
+		return left.index != right.index;
+	}
+
+	const bitfield<T>* field = nullptr;
+	size_t index = 0;
+};
+
+template <typename T>
+class _bitfield_set_bits
+{
+public:
+	_bitfield_set_bits(const bitfield<T>* field) noexcept
+		: field(field)
+	{}
+
+	_bitfield_set_bit_iterator<T> begin() const noexcept
+	{
+		return _bitfield_set_bit_iterator<T>(this->field, 0);
+	}
+	_bitfield_set_bit_iterator<T> end() const noexcept
+	{
+		return _bitfield_set_bit_iterator<T>(this->field, this->field->size());
+	}
+
+private:
+	const bitfield<T>* field;
+};
+
+// Word-at-a-time count/find/fill/copy/equal over bitfield iterators,
+// the way libstdc++ specializes them for vector<bool>. They are found by
+// argument-dependent lookup for unqualified calls; std:: qualified calls
+// still work, one bit at a time.
+
+template <typename T, bool Const>
+std::ptrdiff_t count(_bitfield_iterator<T, Const> first, _bitfield_iterator<T, Const> last, bool value) noexcept
+{
+	const size_t word = _bitfield_container<T>::elem_size;
+	std::ptrdiff_t ones = 0;
+	for (size_t pos = first.index; pos < last.index; pos += word)
+	{
+		ones += std::popcount(first.field->_read_bits(pos, std::min(word, last.index - pos)));
+	}
+
+	return value ? ones : (last - first) - ones;
+}
+
+template <typename T, bool Const>
+_bitfield_iterator<T, Const> find(_bitfield_iterator<T, Const> first, _bitfield_iterator<T, Const> last, bool value) noexcept
+{
+	return _bitfield_iterator<T, Const>(first.field, first.field->_find_bit(first.index, last.index, value));
+}
+
+template <typename T>
+void fill(_bitfield_iterator<T, false> first, _bitfield_iterator<T, false> last, bool value) noexcept
+{
+	const size_t word = _bitfield_container<T>::elem_size;
+	for (size_t pos = first.index; pos < last.index; pos += word)
+	{
+		first.field->_write_bits(pos, std::min(word, last.index - pos), value ? T(-1) : T(0));
+	}
+}
+
+// d_first must not lie in (first, last)
+template <typename T, bool Const>
+_bitfield_iterator<T, false> copy(_bitfield_iterator<T, Const> first, _bitfield_iterator<T, Const> last, _bitfield_iterator<T, false> d_first) noexcept
+{
+	const size_t word = _bitfield_container<T>::elem_size;
+	for (size_t pos = first.index; pos < last.index; pos += word)
+	{
+		const size_t count_bit = std::min(word, last.index - pos);
+		d_first.field->_write_bits(d_first.index + (pos - first.index), count_bit, first.field->_read_bits(pos, count_bit));
+	}
+
+	return d_first + (last - first);
+}
+
+template <typename T, bool Const1, bool Const2>
+bool equal(_bitfield_iterator<T, Const1> first1, _bitfield_iterator<T, Const1> last1, _bitfield_iterator<T, Const2> first2) noexcept
+{
+	const size_t word = _bitfield_container<T>::elem_size;
+	for (size_t pos = first1.index; pos < last1.index; pos += word)
+	{
+		const size_t count_bit = std::min(word, last1.index - pos);
+		if (first1.field->_read_bits(pos, count_bit) != first2.field->_read_bits(first2.index + (pos - first1.index), count_bit)) {
+			return false;
+		}
+	}
 
+	return true;
+}
@@ -138,7 +138,7 @@ struct _subset_iterator : _subset_const_iterator<T, BitmaskType>
 
 
 
-template <typename T, typename BitmaskType = uint8_t>
+template <typename T, typename BitmaskType = uint64_t>
 class subset
 {
 public:
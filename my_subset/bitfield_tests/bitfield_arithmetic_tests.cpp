@@ -116,5 +116,50 @@ TEST(bitfield_arithmetic, and_for_operands_with_different_len)
 	ASSERT_ANY_THROW(a & b);
 }
 
+TEST(bitfield_arithmetic, default_word_is_64_bit)
+{
+	ASSERT_TRUE((std::is_same_v<bitfield_arithmetic<>, bitfield_arithmetic<uint64_t>>));
+}
+
+TEST(bitfield_arithmetic, can_convert_type_with_odd_size)
+{
+	size_t size = 1003;
+	bitfield_arithmetic<uint8_t> a(size);
+	for (size_t i = 0; i < size; i += 3)
+	{
+		a.set_bit(i);
+	}
+
+	bitfield_arithmetic<uint64_t> b(a);
+	bitfield_arithmetic<uint16_t> c(b);
+
+	ASSERT_TRUE(b.size() == size);
+	for (size_t i = 0; i < size; i++)
+	{
+		ASSERT_TRUE(b.read_bit(i) == a.read_bit(i));
+		ASSERT_TRUE(c.read_bit(i) == a.read_bit(i));
+	}
+	ASSERT_TRUE(bitfield_arithmetic<uint8_t>(c) == a);
+}
 
+TEST(bitfield_arithmetic, operators_work_on_long_fields)
+{
+	size_t size = 1001;
+	bitfield_arithmetic<uint16_t> a(size), b(size), full(size, 1);
+	for (size_t i = 0; i < size; i++)
+	{
+		a.write_bit(i, i % 2 == 0);
+		b.write_bit(i, i % 3 == 0);
+	}
 
+	bitfield_arithmetic<uint16_t> and_ab = a & b, or_ab = a | b, xor_ab = a ^ b, sub_ab = a - b, not_a = ~a;
+	for (size_t i = 0; i < size; i++)
+	{
+		ASSERT_TRUE(and_ab.read_bit(i) == (a.read_bit(i) && b.read_bit(i)));
+		ASSERT_TRUE(or_ab.read_bit(i) == (a.read_bit(i) || b.read_bit(i)));
+		ASSERT_TRUE(xor_ab.read_bit(i) == (a.read_bit(i) != b.read_bit(i)));
+		ASSERT_TRUE(sub_ab.read_bit(i) == (a.read_bit(i) && !b.read_bit(i)));
+	}
+	ASSERT_TRUE((not_a | a) == full);
+	ASSERT_TRUE((~full) == bitfield_arithmetic<uint16_t>(size));
+}
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "../MySubset/MyBitfield.h"
 #include <cinttypes>
+#include <vector>
 
 TEST(bitfield, is_correct_element_size)
 {
@@ -502,3 +503,175 @@ TEST(bitfield, new_elements_after_resize_are_null)
 	}
 }
 
+TEST(bitfield, push_back_grows_capacity_geometrically)
+{
+	bitfield<uint8_t> a;
+	size_t reallocations = 0, last_capacity = 0;
+
+	for (size_t i = 0; i < 10000; i++)
+	{
+		a.push_back(i % 3 == 0);
+		if (a.capacity() != last_capacity) {
+			reallocations++;
+			last_capacity = a.capacity();
+		}
+	}
+
+	ASSERT_TRUE(a.size() == 10000);
+	ASSERT_TRUE(reallocations < 20);
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		ASSERT_TRUE(a.read_bit(i) == (i % 3 == 0));
+	}
+}
+
+TEST(bitfield, reserve_and_shrink_to_fit_change_capacity)
+{
+	bitfield<uint32_t> a(10, true);
+
+	a.reserve(1000);
+	ASSERT_TRUE(a.capacity() * 32 >= 1000);
+	ASSERT_TRUE(a.size() == 10);
+
+	a.shrink_to_fit();
+	ASSERT_TRUE(a.capacity() == 1);
+	ASSERT_TRUE(a == bitfield<uint32_t>(10, true));
+}
+
+TEST(bitfield, grown_bits_are_null_after_shrinking_resize)
+{
+	bitfield<uint8_t> a(100, true);
+
+	a.resize(3);
+	a.resize(100);
+
+	for (size_t i = 3; i < a.size(); i++)
+	{
+		ASSERT_TRUE(a.read_bit(i) == 0);
+	}
+}
+
+TEST(bitfield, appender_builds_same_bitfield_as_push_back)
+{
+	bitfield<uint16_t> a, b(5, true);
+	{
+		bitfield_appender<uint16_t> app_a(a), app_b(b);
+		for (size_t i = 0; i < 1000; i++)
+		{
+			app_a.push_back(i % 7 < 3);
+			app_b.push_back(i % 7 < 3);
+		}
+	}
+
+	bitfield<uint16_t> expected_a, expected_b(5, true);
+	for (size_t i = 0; i < 1000; i++)
+	{
+		expected_a.push_back(i % 7 < 3);
+		expected_b.push_back(i % 7 < 3);
+	}
+
+	ASSERT_TRUE(a == expected_a);
+	ASSERT_TRUE(b == expected_b);
+}
+
+TEST(bitfield, iterators_walk_all_bits)
+{
+	bitfield<uint8_t> a(21);
+	a.write_bit(3, 1);
+	a.write_bit(20, 1);
+
+	ASSERT_TRUE(std::distance(a.begin(), a.end()) == 21);
+
+	size_t i = 0;
+	for (bool bit : a)
+	{
+		ASSERT_TRUE(bit == a.read_bit(i));
+		i++;
+	}
+	ASSERT_TRUE(i == a.size());
+	ASSERT_TRUE(a.cbegin()[20] == true);
+	ASSERT_TRUE(*(a.end() - 1) == true);
+}
+
+TEST(bitfield, can_write_through_iterator)
+{
+	bitfield<uint16_t> a(40);
+
+	for (auto it = a.begin(); it != a.end(); it += 3)
+	{
+		*it = true;
+		if (a.end() - it < 3) break;
+	}
+
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		ASSERT_TRUE(a.read_bit(i) == (i % 3 == 0));
+	}
+}
+
+TEST(bitfield, set_bits_lists_indices_of_set_bits)
+{
+	bitfield<uint32_t> a(200);
+	std::vector<size_t> expected = { 0, 31, 32, 65, 130, 199 };
+	for (size_t i : expected)
+	{
+		a.write_bit(i, 1);
+	}
+
+	std::vector<size_t> actual;
+	for (size_t i : a.set_bits())
+	{
+		actual.push_back(i);
+	}
+
+	ASSERT_TRUE(actual == expected);
+	ASSERT_TRUE(bitfield<uint32_t>(50).set_bits().begin() == bitfield<uint32_t>(50).set_bits().end());
+}
+
+TEST(bitfield, word_algorithms_match_bit_loops)
+{
+	bitfield<uint64_t> a(301);
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		a.write_bit(i, (i * 7 + i / 5) % 3 == 0);
+	}
+
+	for (size_t first = 0; first < 140; first += 13)
+	{
+		for (size_t last = first; last <= a.size(); last += 37)
+		{
+			std::ptrdiff_t ones = 0;
+			size_t first_zero = last;
+			for (size_t i = first; i < last; i++)
+			{
+				ones += a.read_bit(i);
+				if (first_zero == last && !a.read_bit(i)) first_zero = i;
+			}
+
+			ASSERT_TRUE(count(a.cbegin() + first, a.cbegin() + last, true) == ones);
+			ASSERT_TRUE(count(a.cbegin() + first, a.cbegin() + last, false) == std::ptrdiff_t(last - first) - ones);
+			ASSERT_TRUE(find(a.cbegin() + first, a.cbegin() + last, false) - a.cbegin() == std::ptrdiff_t(first_zero));
+
+			bitfield<uint64_t> b(a.size() + 11), c(a.size() + 11, true);
+			auto b_end = copy(a.cbegin() + first, a.cbegin() + last, b.begin() + 5);
+			ASSERT_TRUE(b_end - b.begin() == std::ptrdiff_t(5 + last - first));
+			ASSERT_TRUE(equal(a.cbegin() + first, a.cbegin() + last, b.cbegin() + 5));
+
+			fill(c.begin() + first, c.begin() + last, false);
+			for (size_t i = 0; i < c.size(); i++)
+			{
+				ASSERT_TRUE(b.read_bit(i) == (i >= 5 && i < 5 + last - first && a.read_bit(i - 5 + first)));
+				ASSERT_TRUE(c.read_bit(i) == !(i >= first && i < last));
+			}
+		}
+	}
+}
+
+TEST(bitfield, equal_detects_single_bit_difference)
+{
+	bitfield<uint8_t> a(77, true), b(77, true);
+	b.write_bit(70, 0);
+
+	ASSERT_TRUE(equal(a.begin(), a.begin() + 70, b.begin()));
+	ASSERT_TRUE(!equal(a.begin(), a.end(), b.begin()));
+}
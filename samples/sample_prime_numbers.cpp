@@ -4,91 +4,271 @@
 //   Переработано для Microsoft Visual Studio 2008 Сысоевым А.В. (19.04.2015)
 //
 // Тестирование битового поля и множества
+//
+// Без аргументов граница запрашивается с клавиатуры и печатаются все
+// простые. Для замеров:
+//   sample_prime_numbers -n 1000000000 -b segmented -w 30 -t 4 -r 5 -c
+//   -n N          верхняя граница
+//   -b BACKEND    bitfield | set | segmented
+//   -w WHEEL      колесо для segmented: none | odd | 30
+//   -t THREADS    потоки для segmented (0 - по числу ядер)
+//   -r REPEAT     к-во повторов, печатается лучшее и среднее время
+//   -c            только подсчет, без печати простых
 
 #include <iomanip>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 
- //#define USE_SET // Использовать класс TSet,
-                // закоментировать, чтобы использовать битовое поле
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
 
-#ifndef USE_SET // Использовать класс TBitField
+#include "tset.h"
+#include "tsieve.h"
 
-#include "tbitfield.h"
+ //#define USE_SET // Использовать класс TSet по умолчанию,
+                // закоментировать, чтобы использовать битовое поле
 
-int main()
+// печать i-го простого по 10 в строке
+static void PrintPrime(long long m, long long k)
 {
-  int n, m, k, count;
+  cout << setw(3) << m << " ";
+  if (k % 10 == 0)
+    cout << '\n';
+}
 
-  setlocale(LC_ALL, "Russian");
-  cout << "Тестирование программ поддержки битового поля" << endl;
-  cout << "             Решето Эратосфена" << endl;
-  cout << "Введите верхнюю границу целых значений - ";
-  cin  >> n;
-  TBitField s(n + 1);
+// решето на одном битовом поле
+static long long SieveBitField(long long n, bool print)
+{
+  int m, k;
+  long long count;
+
+  TBitField s(int(n + 1));
   // заполнение множества
   for (m = 2; m <= n; m++)
     s.SetBit(m);
   // проверка до sqrt(n) и удаление кратных
-  for (m = 2; m * m <= n; m++)
+  for (m = 2; (long long)m * m <= n; m++)
     // если m в s, удаление кратных
     if (s.GetBit(m))
       for (k = 2 * m; k <= n; k += m)
         if (s.GetBit(k))
           s.ClrBit(k);
   // оставшиеся в s элементы - простые числа
-  cout << endl << "Печать множества некратных чисел" << endl << s << endl;
-  cout << endl << "Печать простых чисел" << endl;
+  if (print)
+    cout << '\n' << "Печать множества некратных чисел" << '\n' << s << '\n'
+         << '\n' << "Печать простых чисел" << '\n';
   count = 0;
-  k = 1;
   for (m = 2; m <= n; m++)
     if (s.GetBit(m))
     {
       count++;
-      cout << setw(3) << m << " ";
-      if (k++ % 10 == 0)
-        cout << endl;
+      if (print)
+        PrintPrime(m, count);
     }
-  cout << endl;
-  cout << "В первых " << n << " числах " << count << " простых" << endl;
+  return count;
 }
-#else
-
-#include "tset.h"
 
-int main()
+// решето на множестве
+static long long SieveSet(long long n, bool print)
 {
-  int n, m, k, count;
+  int m, k;
+  long long count;
 
-  setlocale(LC_ALL, "Russian");
-  cout << "Тестирование программ поддержки множества" << endl;
-  cout << "              Решето Эратосфена" << endl;
-  cout << "Введите верхнюю границу целых значений - ";
-  cin  >> n;
-  TSet s(n + 1);
+  TSet s(int(n + 1));
   // заполнение множества
   for (m = 2; m <= n; m++)
     s.InsElem(m);
   // проверка до sqrt(n) и удаление кратных
-  for (m = 2; m * m <= n; m++)
+  for (m = 2; (long long)m * m <= n; m++)
     // если м в s, удаление кратных
     if (s.IsMember(m))
       for (k = 2 * m; k <= n; k += m)
-       if (s.IsMember(k))
-         s.DelElem(k);
+        if (s.IsMember(k))
+          s.DelElem(k);
   // оставшиеся в s элементы - простые числа
-  cout << endl << "Печать множества некратных чисел" << endl << s << endl;
-  cout << endl << "Печать простых чисел" << endl;
+  if (print)
+    cout << '\n' << "Печать множества некратных чисел" << '\n' << s << '\n'
+         << '\n' << "Печать простых чисел" << '\n';
   count = 0;
-  k = 1;
   for (m = 2; m <= n; m++)
     if (s.IsMember(m))
     {
       count++;
-      cout << setw(3) << m << " ";
-      if (k++ % 10 == 0)
-        cout << endl;
+      if (print)
+        PrintPrime(m, count);
+    }
+  return count;
+}
+
+// сегментированное решето, память - O(sqrt(n))
+static long long SieveSegmented(long long n, TSieveWheel wheel, int threads, bool print)
+{
+  TSegmentedSieve sieve(n, SieveSegmentLen, wheel);
+  if (!print)
+    return threads == 1 ? sieve.Count() : sieve.Count(threads);
+
+  long long count = 0;
+  if (wheel == WheelNone)
+  {
+    cout << '\n' << "Печать множества некратных чисел" << '\n';
+    sieve.ForEachSegment([](long long, const TBitField &s) { cout << s; });
+    cout << '\n';
+  }
+  cout << '\n' << "Печать простых чисел" << '\n';
+  sieve.ForEachPrime([&count](long long m) { PrintPrime(m, ++count); });
+  return count;
+}
+
+// пиковый объем памяти процесса в Кбайт
+static long long PeakMemoryKb()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return (long long)(pmc.PeakWorkingSetSize / 1024);
+  return 0;
+#else
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static int Usage(const char *name)
+{
+  cerr << "Использование: " << name
+       << " [-n N] [-b bitfield|set|segmented] [-w none|odd|30] [-t THREADS] [-r REPEAT] [-c]" << endl;
+  return 2;
+}
+
+// целое из строки целиком в диапазоне [min, max]
+static bool ParseNumber(const char *str, long long min, long long max, long long &val)
+{
+  char *end = nullptr;
+  errno = 0;
+  val = strtoll(str, &end, 10);
+  return end != str && *end == '\0' && errno == 0 && val >= min && val <= max;
+}
+
+static int BadValue(const char *option, const char *what)
+{
+  cerr << "Параметр " << option << ": " << what << endl;
+  return 2;
+}
+
+int main(int argc, char **argv)
+{
+  long long n = -1;
+#ifdef USE_SET
+  string backend = "set";
+#else
+  string backend = "segmented";
+#endif
+  TSieveWheel wheel = WheelNone;
+  int threads = 1, repeat = 1;
+  long long val = 0;
+  bool print = true;
+
+  setlocale(LC_ALL, "Russian");
+  for (int i = 1; i < argc; i++)
+  {
+    const bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "-c"))
+      print = false;
+    else if (!strcmp(argv[i], "-n") && hasValue)
+    {
+      if (!ParseNumber(argv[++i], 0, LLONG_MAX, n))
+        return BadValue("-n", "граница должна быть неотрицательным целым числом");
+    }
+    else if (!strcmp(argv[i], "-b") && hasValue)
+      backend = argv[++i];
+    else if (!strcmp(argv[i], "-t") && hasValue)
+    {
+      if (!ParseNumber(argv[++i], 0, INT_MAX, val))
+        return BadValue("-t", "к-во потоков должно быть неотрицательным целым числом");
+      threads = int(val);
     }
+    else if (!strcmp(argv[i], "-r") && hasValue)
+    {
+      if (!ParseNumber(argv[++i], 1, INT_MAX, val))
+        return BadValue("-r", "к-во повторов должно быть положительным целым числом");
+      repeat = int(val);
+    }
+    else if (!strcmp(argv[i], "-w") && hasValue)
+    {
+      const string w = argv[++i];
+      if (w == "none")
+        wheel = WheelNone;
+      else if (w == "odd")
+        wheel = WheelOdd;
+      else if (w == "30")
+        wheel = Wheel30;
+      else
+        return BadValue("-w", "ожидается none, odd или 30");
+    }
+    else
+      return Usage(argv[0]);
+  }
+  if (backend != "bitfield" && backend != "set" && backend != "segmented")
+    return BadValue("-b", "ожидается bitfield, set или segmented");
+
+  if (n < 0)
+  {
+    cout << "Тестирование программ поддержки " << (backend == "set" ? "множества" : "битового поля") << endl;
+    cout << "             Решето Эратосфена" << endl;
+    cout << "Введите верхнюю границу целых значений - ";
+    if (!(cin >> n))
+      n = -1;
+  }
+  if (n < 0)
+  {
+    cerr << "Граница должна быть неотрицательным целым числом" << endl;
+    return 2;
+  }
+  if (backend != "segmented" && n >= INT_MAX)
+  {
+    cerr << "Для " << backend << " граница должна быть меньше " << INT_MAX << endl;
+    return 2;
+  }
+
+  long long count = 0;
+  double best = 0, total = 0;
+  for (int r = 0; r < repeat; r++)
+  {
+    const auto start = chrono::steady_clock::now();
+    if (backend == "bitfield")
+      count = SieveBitField(n, print && r == 0);
+    else if (backend == "set")
+      count = SieveSet(n, print && r == 0);
+    else
+      count = SieveSegmented(n, wheel, threads, print && r == 0);
+    const double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    best = r == 0 ? time : min(best, time);
+    total += time;
+  }
+
   cout << endl;
   cout << "В первых " << n << " числах " << count << " простых" << endl;
+  if (!print || repeat > 1)
+  {
+    cout << "Время: лучшее " << best << " с, среднее " << total / repeat << " с" << endl;
+    cout << "Скорость: " << (n + 1) / best << " бит/с" << endl;
+    cout << "Пиковая память: " << PeakMemoryKb() << " Кбайт" << endl;
+  }
 }
-
-#endif
\ No newline at end of file
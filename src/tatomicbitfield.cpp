@@ -0,0 +1,135 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tatomicbitfield.cpp
+//
+// Битовое поле с атомарными операциями над битами
+
+#include "tatomicbitfield.h"
+#include "tbitops.h"
+#include <new>
+#include <stdexcept>
+
+static const int AtomicLineElems = CacheLineSize / sizeof(std::atomic<TELEM>);
+
+TAtomicBitField::TAtomicBitField(int len)
+	: BitLen(len)
+	, pMem(nullptr)
+	, MemLen(0)
+{
+	if (len < 0) {
+		throw std::logic_error("negative size...");
+	}
+
+	this->MemLen = ((len + TELEMBits - 1) / TELEMBits + AtomicLineElems - 1) / AtomicLineElems * AtomicLineElems;
+	void* mem = ::operator new[](std::size_t(this->MemLen) * sizeof(std::atomic<TELEM>), std::align_val_t(CacheLineSize));
+	this->pMem = static_cast<std::atomic<TELEM>*>(mem);
+	for (int i = 0; i < this->MemLen; i++)
+	{
+		new (this->pMem + i) std::atomic<TELEM>(0);
+	}
+}
+
+TAtomicBitField::~TAtomicBitField()
+{
+	for (int i = 0; i < this->MemLen; i++)
+	{
+		this->pMem[i].~atomic();
+	}
+	::operator delete[](static_cast<void*>(this->pMem), std::align_val_t(CacheLineSize));
+}
+
+void TAtomicBitField::CheckIndex(const int n) const // проверка номера бита
+{
+	if (n < 0 || n >= this->BitLen) {
+		throw std::out_of_range("invalid arg");
+	}
+}
+
+// доступ к битам
+
+int TAtomicBitField::GetLength() const // получить длину (к-во битов)
+{
+	return this->BitLen;
+}
+
+void TAtomicBitField::SetBit(const int n, std::memory_order order) // установить бит
+{
+	this->CheckIndex(n);
+	this->pMem[n / TELEMBits].fetch_or(TELEM(1) << (n % TELEMBits), order);
+}
+
+void TAtomicBitField::ClrBit(const int n, std::memory_order order) // очистить бит
+{
+	this->CheckIndex(n);
+	this->pMem[n / TELEMBits].fetch_and(~(TELEM(1) << (n % TELEMBits)), order);
+}
+
+int TAtomicBitField::GetBit(const int n, std::memory_order order) const // получить значение бита
+{
+	this->CheckIndex(n);
+	return bool(this->pMem[n / TELEMBits].load(order) & (TELEM(1) << (n % TELEMBits)));
+}
+
+bool TAtomicBitField::TestAndSet(const int n, std::memory_order order) // установить, вернуть прежнее значение
+{
+	this->CheckIndex(n);
+
+	const TELEM mask = TELEM(1) << (n % TELEMBits);
+	return bool(this->pMem[n / TELEMBits].fetch_or(mask, order) & mask);
+}
+
+bool TAtomicBitField::TestAndClear(const int n, std::memory_order order) // очистить, вернуть прежнее значение
+{
+	this->CheckIndex(n);
+
+	const TELEM mask = TELEM(1) << (n % TELEMBits);
+	return bool(this->pMem[n / TELEMBits].fetch_and(~mask, order) & mask);
+}
+
+// доступ к памяти
+
+int TAtomicBitField::GetMemLen() const // к-во эл-тов Мем
+{
+	return this->MemLen;
+}
+
+const std::atomic<TELEM>* TAtomicBitField::GetMem() const // память
+{
+	return this->pMem;
+}
+
+TELEM TAtomicBitField::LoadWord(const int i, std::memory_order order) const // прочитать эл-т
+{
+	if (i < 0 || i >= this->MemLen) {
+		throw std::out_of_range("invalid arg");
+	}
+
+	return this->pMem[i].load(order);
+}
+
+bool TAtomicBitField::CompareExchangeWord(const int i, TELEM& expected, TELEM desired, std::memory_order order) // сравнить и заменить эл-т
+{
+	if (i < 0 || i >= this->MemLen) {
+		throw std::out_of_range("invalid arg");
+	}
+
+	// биты за пределами BitLen не должны устанавливаться
+	const int tail = this->BitLen - i * TELEMBits;
+	if (tail < TELEMBits) {
+		desired &= tail <= 0 ? TELEM(0) : TELEM(-1) >> (TELEMBits - tail);
+	}
+
+	return this->pMem[i].compare_exchange_weak(expected, desired, order, std::memory_order_relaxed);
+}
+
+TBitField TAtomicBitField::ToBitField() const // копия
+{
+	TBitField temp(this->BitLen);
+	TELEM* mem = temp.GetMem();
+	for (int i = 0; i < temp.GetMemLen(); i++)
+	{
+		mem[i] = this->pMem[i].load(std::memory_order_acquire);
+	}
+
+	return temp;
+}
@@ -6,12 +6,18 @@
 // Битовое поле
 
 #include "tbitfield.h"
+#include "tbitops.h"
 #include <exception>
 #include <type_traits>
 #include <cstddef>
 #include <string>
 #include <algorithm>
 #include <utility>
+#include <cstdint>
+#include <climits>
+#include <stdexcept>
+#include <atomic>
+#include <new>
 
 #pragma warning(disable:26409)
 #pragma warning(disable:26481)
@@ -23,31 +29,111 @@ inline constexpr static std::size_t _bits_to_size(std::size_t val)
 	return (val + 8 * sizeof(T) - 1) / (8 * sizeof(T));
 }
 
-TBitField::TBitField(int len)
+// к-во эл-тов памяти с дополнением до BitFieldAlign байт
+static std::size_t _padded_len(std::size_t memLen)
+{
+	const std::size_t align = BitFieldAlign / sizeof(TELEM);
+	return (memLen + align - 1) / align * align;
+}
+
+// общая память битовых полей: заголовок со счетчиком ссылок, затем эл-ты;
+// заголовок занимает строку кэша, поэтому эл-ты выровнены на BitFieldAlign
+struct alignas(BitFieldAlign) TBitFieldRep
+{
+	std::atomic<int> Refs;                   // к-во полей, использующих память
+	std::pmr::memory_resource* pResource;    // откуда выделена память
+	std::size_t Size;                        // размер блока в байтах
+};
+
+static TBitFieldRep* _rep(const TELEM* mem)
+{
+	return reinterpret_cast<TBitFieldRep*>(const_cast<TELEM*>(mem)) - 1;
+}
+
+static TELEM* _mem_alloc(std::size_t memLen, std::pmr::memory_resource* mr) // новая память, заполненная нулями
+{
+	memLen = _padded_len(memLen);
+	const std::size_t size = sizeof(TBitFieldRep) + memLen * sizeof(TELEM);
+	void* block = mr->allocate(size, alignof(TBitFieldRep));
+	TBitFieldRep* rep = new (block) TBitFieldRep;
+	rep->Refs.store(1, std::memory_order_relaxed);
+	rep->pResource = mr;
+	rep->Size = size;
+
+	TELEM* mem = reinterpret_cast<TELEM*>(rep + 1);
+	std::fill(mem, mem + memLen, TELEM(0));
+	return mem;
+}
+
+static TELEM* _mem_share(TELEM* mem) // еще одна ссылка на память
+{
+	_rep(mem)->Refs.fetch_add(1, std::memory_order_relaxed);
+	return mem;
+}
+
+static void _mem_release(TELEM* mem) // освободить ссылку на память
+{
+	TBitFieldRep* rep = _rep(mem);
+	if (rep->Refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		std::pmr::memory_resource* mr = rep->pResource;
+		const std::size_t size = rep->Size;
+		rep->~TBitFieldRep();
+		mr->deallocate(rep, size, alignof(TBitFieldRep));
+	}
+}
+
+TBitField::TBitField(int len, std::pmr::memory_resource* mr)
 	: BitLen(len)
-	, pMem(new std::remove_pointer_t<decltype(pMem)>[_bits_to_size<std::remove_pointer<decltype(pMem)>>(len)]{})
-	, MemLen(_bits_to_size<std::remove_pointer_t<decltype(pMem)>>(len))
+	, pMem(nullptr)
+	, MemLen(0)
 {
 	if (len < 0) {
-		delete[] pMem;
 		throw std::logic_error("negative size...");
 	}
+
+	this->MemLen = _bits_to_size<std::remove_pointer_t<decltype(pMem)>>(len);
+	this->pMem = _mem_alloc(this->MemLen, mr);
 }
 
 TBitField::TBitField(const TBitField& bf) // конструктор копирования
 	: BitLen(bf.BitLen)
-	, pMem(new std::remove_pointer_t<decltype(pMem)>[bf.MemLen])
+	, pMem(_mem_share(bf.pMem))
 	, MemLen(bf.MemLen)
 {
-	for (size_t i = 0; i < this->MemLen; i++)
-	{
-		this->pMem[i] = bf.pMem[i];
+}
+
+TBitField::TBitField(const TBitField& bf, std::pmr::memory_resource* mr) // копия в заданной памяти
+	: BitLen(bf.BitLen)
+	, pMem(nullptr)
+	, MemLen(bf.MemLen)
+{
+	if (bf.GetResource() == mr) {
+		this->pMem = _mem_share(bf.pMem);
+	}
+	else {
+		this->pMem = _mem_alloc(this->MemLen, mr);
+		std::copy(bf.pMem, bf.pMem + bf.MemLen, this->pMem);
 	}
 }
 
 TBitField::~TBitField()
 {
-	delete[] this->pMem;
+	_mem_release(this->pMem);
+}
+
+void TBitField::Detach() // собственная копия общей памяти
+{
+	if (_rep(this->pMem)->Refs.load(std::memory_order_acquire) == 1) return;
+
+	TELEM* mem = _mem_alloc(this->MemLen, this->GetResource());
+	std::copy(this->pMem, this->pMem + this->MemLen, mem);
+	_mem_release(this->pMem);
+	this->pMem = mem;
+}
+
+std::pmr::memory_resource* TBitField::GetResource() const // ресурс памяти
+{
+	return _rep(this->pMem)->pResource;
 }
 
 int TBitField::GetMemIndex(const int n) const // индекс Мем для бита n
@@ -73,6 +159,7 @@ void TBitField::SetBit(const int n) // установить бит
 		throw std::out_of_range("invalid arg");
 	}
 
+	this->Detach();
 	this->pMem[this->GetMemIndex(n)] |= this->GetMemMask(n);
 }
 
@@ -82,6 +169,7 @@ void TBitField::ClrBit(const int n) // очистить бит
 		throw std::out_of_range("invalid arg");
 	}
 	
+	this->Detach();
 	this->pMem[this->GetMemIndex(n)] &= ~this->GetMemMask(n);
 }
 
@@ -94,6 +182,41 @@ int TBitField::GetBit(const int n) const // получить значение б
 	return bool(this->pMem[this->GetMemIndex(n)] & this->GetMemMask(n));
 }
 
+int TBitField::GetCount() const // к-во установленных битов
+{
+	int count = 0;
+	const int padded = this->GetPaddedMemLen();
+	for (int i = 0; i < padded; i++)
+	{
+		count += _popcount(this->pMem[i]);
+	}
+
+	return count;
+}
+
+// доступ к памяти
+
+int TBitField::GetMemLen() const // к-во эл-тов Мем
+{
+	return this->MemLen;
+}
+
+int TBitField::GetPaddedMemLen() const // к-во эл-тов с дополнением
+{
+	return int(_padded_len(this->MemLen));
+}
+
+const TELEM* TBitField::GetMem() const // память битового поля
+{
+	return this->pMem;
+}
+
+TELEM* TBitField::GetMem() // память битового поля
+{
+	this->Detach();
+	return this->pMem;
+}
+
 // битовые операции
 #pragma warning(push)
 #pragma warning(disable:26440)
@@ -102,17 +225,11 @@ TBitField& TBitField::operator=(const TBitField& bf) // присваивание
 {
 	if (this == &bf) return *this;
 
-	if (this->MemLen != bf.MemLen) {
-		this->~TBitField();
-		new (this) TBitField(bf);
-	}
-	else {
-		this->BitLen = bf.BitLen;
-		for (size_t i = 0; i < this->MemLen; i++)
-		{
-			this->pMem[i] = bf.pMem[i];
-		}
-	}
+	TELEM* mem = _mem_share(bf.pMem);
+	_mem_release(this->pMem);
+	this->pMem = mem;
+	this->BitLen = bf.BitLen;
+	this->MemLen = bf.MemLen;
 
 	return *this;
 }
@@ -122,8 +239,11 @@ int TBitField::operator==(const TBitField& bf) const // сравнение
 {
 	if (this == &bf) return true;
 	if (this->BitLen != bf.BitLen) return false;
+	if (this->pMem == bf.pMem) return true;
 
-	for (std::size_t i = 0; i < this->MemLen; i++)
+	// дополнение у обоих полей нулевое
+	const std::size_t padded = this->GetPaddedMemLen();
+	for (std::size_t i = 0; i < padded; i++)
 	{
 		if (this->pMem[i] != bf.pMem[i]) return false;
 	}
@@ -145,7 +265,7 @@ TBitField TBitField::operator|(const TBitField& bf) // операция "или"
 		catch (...)
 		{}
 
-		TBitField temp(std::max(this->BitLen, bf.BitLen));
+		TBitField temp(std::max(this->BitLen, bf.BitLen), this->GetResource());
 		for (size_t i = 0; i < this->MemLen && i < bf.MemLen; i++)
 		{
 			temp.pMem[i] = this->pMem[i];
@@ -155,10 +275,10 @@ TBitField TBitField::operator|(const TBitField& bf) // операция "или"
 		new (this) TBitField(std::move(temp));
 	}
 
-	TBitField temp(*this);
-	for (size_t i = 0; i < this->MemLen; i++)
+	TBitField temp(this->BitLen, this->GetResource());
+	for (int i = 0; i < this->MemLen; i++)
 	{
-		temp.pMem[i] |= bf.pMem[i];
+		temp.pMem[i] = this->pMem[i] | (i < bf.MemLen ? bf.pMem[i] : 0);
 	}
 
 	return temp;
@@ -173,7 +293,7 @@ TBitField TBitField::operator&(const TBitField& bf) // операция "и"
 		catch (...)
 		{}
 
-		TBitField temp(std::max(this->BitLen, bf.BitLen));
+		TBitField temp(std::max(this->BitLen, bf.BitLen), this->GetResource());
 		for (size_t i = 0; i < this->MemLen && i < bf.MemLen; i++)
 		{
 			temp.pMem[i] = this->pMem[i];
@@ -183,10 +303,10 @@ TBitField TBitField::operator&(const TBitField& bf) // операция "и"
 		new (this) TBitField(std::move(temp));
 	}
 
-	TBitField temp(*this);
-	for (size_t i = 0; i < temp.MemLen; i++)
+	TBitField temp(this->BitLen, this->GetResource());
+	for (int i = 0; i < temp.MemLen && i < bf.MemLen; i++)
 	{
-		temp.pMem[i] &= bf.pMem[i];
+		temp.pMem[i] = this->pMem[i] & bf.pMem[i];
 	}
 
 	return temp;
@@ -194,13 +314,15 @@ TBitField TBitField::operator&(const TBitField& bf) // операция "и"
 
 TBitField TBitField::operator~() // отрицание
 {
-	TBitField temp(*this);
+	TBitField temp(this->BitLen, this->GetResource());
 	for (size_t i = 0; i < temp.MemLen; i++)
 	{
-		temp.pMem[i] = ~temp.pMem[i];
+		temp.pMem[i] = ~this->pMem[i];
+	}
+	if (temp.BitLen % (8 * sizeof(std::remove_pointer_t<decltype(pMem)>)) != 0) {
+		temp.pMem[temp.MemLen - 1] &= std::remove_pointer_t<decltype(pMem)>(-1) >>
+			(8 * sizeof(std::remove_pointer_t<decltype(pMem)>) - temp.BitLen % (8 * sizeof(std::remove_pointer_t<decltype(pMem)>)));
 	}
-	temp.pMem[temp.MemLen - 1] &= std::remove_pointer_t<decltype(pMem)>(-1) >> 
-		(8 * sizeof(std::remove_pointer_t<decltype(pMem)>) - temp.BitLen % (8 * sizeof(std::remove_pointer_t<decltype(pMem)>)));
 
 	return temp;
 }
@@ -218,8 +340,9 @@ istream& operator>>(istream& istr, TBitField& bf) // ввод
 	size_t nsize = input_data.size();
 
 	if (bf.MemLen < nsize) {
+		std::pmr::memory_resource* mr = bf.GetResource();
 		bf.~TBitField();
-		new (&bf) TBitField(nsize);
+		new (&bf) TBitField(nsize, mr);
 	}
 
 	for (size_t i = 0; i < nsize; i++)
@@ -250,3 +373,82 @@ ostream& operator<<(ostream& ostr, const TBitField& bf) // вывод
 
 	return ostr;
 }
+
+// двоичный ввод/вывод
+
+void TBitField::Save(ostream& ostr) const // запись в двоичном виде
+{
+	const std::uint64_t len = this->BitLen;
+	ostr.write(reinterpret_cast<const char*>(&len), sizeof(len));
+	ostr.write(reinterpret_cast<const char*>(this->pMem), std::streamsize(this->MemLen) * sizeof(TELEM));
+}
+
+void TBitField::Load(istream& istr) // чтение из двоичного вида
+{
+	std::uint64_t len = 0;
+	if (!istr.read(reinterpret_cast<char*>(&len), sizeof(len))) {
+		throw std::runtime_error("bad bitfield header");
+	}
+	if (len > INT_MAX) {
+		throw std::length_error("bitfield is too long");
+	}
+
+	TBitField temp(static_cast<int>(len), this->GetResource());
+	if (!istr.read(reinterpret_cast<char*>(temp.pMem), std::streamsize(temp.MemLen) * sizeof(TELEM))) {
+		throw std::runtime_error("truncated bitfield data");
+	}
+	if (temp.BitLen % (8 * sizeof(TELEM)) != 0) {
+		temp.pMem[temp.MemLen - 1] &= TELEM(-1) >> (8 * sizeof(TELEM) - temp.BitLen % (8 * sizeof(TELEM)));
+	}
+
+	*this = temp;
+}
+
+// битовое поле во внешней памяти
+
+TBitFieldView::TBitFieldView(const TELEM* mem, int len)
+	: BitLen(len)
+	, pMem(mem)
+{
+	if (len < 0) {
+		throw std::logic_error("negative size...");
+	}
+}
+
+TBitFieldView::TBitFieldView(const TBitField& bf)
+	: BitLen(bf.GetLength())
+	, pMem(bf.GetMem())
+{
+}
+
+int TBitFieldView::GetLength() const // получить длину (к-во битов)
+{
+	return this->BitLen;
+}
+
+int TBitFieldView::GetBit(const int n) const // получить значение бита
+{
+	if (n < 0 || n >= this->BitLen) {
+		throw std::out_of_range("invalid arg");
+	}
+
+	return bool(this->pMem[n / TELEMBits] & (TELEM{ 1 } << (n % TELEMBits)));
+}
+
+int TBitFieldView::GetMemLen() const // к-во эл-тов Мем
+{
+	return int(_bits_to_size<TELEM>(this->BitLen));
+}
+
+const TELEM* TBitFieldView::GetMem() const // память битового поля
+{
+	return this->pMem;
+}
+
+TBitField TBitFieldView::ToBitField() const // копия в виде битового поля
+{
+	TBitField temp(this->BitLen);
+	std::copy(this->pMem, this->pMem + this->GetMemLen(), temp.GetMem());
+
+	return temp;
+}
@@ -0,0 +1,116 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tbitfieldpool.cpp
+//
+// Потоковый пул буферов для временных битовых полей
+
+#include "tbitfieldpool.h"
+
+// свободные буферы одного размера
+struct TPoolClass
+{
+	std::size_t Bytes = 0, Align = 0; // 0 - класс не занят
+	int Count = 0;
+	void* Blocks[PoolClassCapacity];
+};
+
+// состояние пула потока; тривиально уничтожаемо, поэтому доступно и после
+// уничтожения пула (поля со статическим временем жизни освобождаются позже
+// thread_local объектов главного потока)
+enum TThreadPoolState { PoolNotCreated, PoolAlive, PoolDestroyed };
+static thread_local TThreadPoolState ThreadPoolState = PoolNotCreated;
+
+// пул потока; при завершении потока буферы возвращаются в кучу
+struct TThreadPool
+{
+	TPoolClass Classes[PoolSizeClasses];
+	long long Hits = 0, Misses = 0;
+
+	TThreadPool()
+	{
+		ThreadPoolState = PoolAlive;
+	}
+
+	~TThreadPool()
+	{
+		ThreadPoolState = PoolDestroyed;
+		for (TPoolClass& c : this->Classes)
+		{
+			for (int i = 0; i < c.Count; i++)
+			{
+				std::pmr::new_delete_resource()->deallocate(c.Blocks[i], c.Bytes, c.Align);
+			}
+		}
+	}
+
+	TPoolClass* Find(std::size_t bytes, std::size_t align, bool create)
+	{
+		TPoolClass* empty = nullptr;
+		for (TPoolClass& c : this->Classes)
+		{
+			if (c.Bytes == bytes && c.Align == align) return &c;
+			if (empty == nullptr && c.Count == 0) empty = &c;
+		}
+		if (!create || empty == nullptr) return nullptr;
+
+		empty->Bytes = bytes;
+		empty->Align = align;
+		return empty;
+	}
+};
+
+static thread_local TThreadPool ThreadPool;
+
+TBitFieldPool& TBitFieldPool::Get() // единственный экземпляр
+{
+	static TBitFieldPool pool;
+	return pool;
+}
+
+void* TBitFieldPool::do_allocate(std::size_t bytes, std::size_t align)
+{
+	if (ThreadPoolState == PoolDestroyed) {
+		return std::pmr::new_delete_resource()->allocate(bytes, align);
+	}
+
+	TPoolClass* c = ThreadPool.Find(bytes, align, false);
+	if (c != nullptr && c->Count > 0) {
+		ThreadPool.Hits++;
+		return c->Blocks[--c->Count];
+	}
+
+	ThreadPool.Misses++;
+	return std::pmr::new_delete_resource()->allocate(bytes, align);
+}
+
+void TBitFieldPool::do_deallocate(void* p, std::size_t bytes, std::size_t align)
+{
+	if (ThreadPoolState == PoolDestroyed) {
+		std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+		return;
+	}
+
+	// пустой класс может быть занят другим размером
+	TPoolClass* c = ThreadPool.Find(bytes, align, true);
+	if (c != nullptr && c->Count < PoolClassCapacity) {
+		c->Blocks[c->Count++] = p;
+		return;
+	}
+
+	std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+}
+
+bool TBitFieldPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+long long TBitFieldPool::GetHitCount() // выделений из пула в этом потоке
+{
+	return ThreadPoolState == PoolDestroyed ? 0 : ThreadPool.Hits;
+}
+
+long long TBitFieldPool::GetMissCount() // выделений из кучи в этом потоке
+{
+	return ThreadPoolState == PoolDestroyed ? 0 : ThreadPool.Misses;
+}
@@ -0,0 +1,249 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tbitstream.cpp
+//
+// Порционное чтение и запись битового поля
+
+#include "tbitstream.h"
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+static int _chunk_len_for(unsigned long long len, int chunkLen)
+{
+	if (chunkLen <= 0 || chunkLen % (8 * sizeof(TELEM)) != 0) {
+		throw std::logic_error("chunk length must be a positive multiple of the word size");
+	}
+
+	return int(std::min<unsigned long long>(len, chunkLen));
+}
+
+// чтение
+
+TBitStreamReader::TBitStreamReader(istream& istr, int chunkLen)
+	: Stream(istr)
+	, BitLen(0)
+	, ReadPos(0)
+	, ChunkPos(0)
+	, ChunkLen(chunkLen)
+	, Buf0(0)
+	, Buf1(0)
+	, pFront(&Buf0)
+	, pBack(&Buf1)
+{
+	std::uint64_t len = 0;
+	if (!this->Stream.read(reinterpret_cast<char*>(&len), sizeof(len))) {
+		throw std::runtime_error("bad bit stream header");
+	}
+	this->BitLen = len;
+
+	const int bufLen = _chunk_len_for(this->BitLen, chunkLen);
+	this->Buf0 = TBitField(bufLen);
+	this->Buf1 = TBitField(bufLen);
+
+	this->StartRead();
+}
+
+TBitStreamReader::~TBitStreamReader()
+{
+	if (this->Pending.valid()) {
+		this->Pending.wait();
+	}
+}
+
+bool TBitStreamReader::ReadChunk(TBitField* pBuf) // прочитать порцию в буфер
+{
+	if (this->ReadPos >= this->BitLen) return false;
+
+	const int len = int(std::min<unsigned long long>(this->ChunkLen, this->BitLen - this->ReadPos));
+	if (pBuf->GetLength() != len) {
+		*pBuf = TBitField(len);
+	}
+
+	TELEM* mem = pBuf->GetMem();
+	const int memLen = pBuf->GetMemLen();
+	if (!this->Stream.read(reinterpret_cast<char*>(mem), std::streamsize(memLen) * sizeof(TELEM))) {
+		throw std::runtime_error("truncated bit stream");
+	}
+	if (len % (8 * sizeof(TELEM)) != 0) {
+		mem[memLen - 1] &= TELEM(-1) >> (8 * sizeof(TELEM) - len % (8 * sizeof(TELEM)));
+	}
+
+	this->ReadPos += len;
+	return true;
+}
+
+void TBitStreamReader::StartRead() // начать фоновое чтение следующей порции
+{
+	TBitField* pBuf = this->pBack;
+	this->Pending = std::async(std::launch::async, [this, pBuf] { return this->ReadChunk(pBuf); });
+}
+
+unsigned long long TBitStreamReader::GetLength() const // длина потока в битах
+{
+	return this->BitLen;
+}
+
+int TBitStreamReader::GetChunkLen() const // длина порции в битах
+{
+	return this->ChunkLen;
+}
+
+bool TBitStreamReader::Next() // перейти к следующей порции
+{
+	if (!this->Pending.valid() || !this->Pending.get()) return false;
+
+	std::swap(this->pFront, this->pBack);
+	this->ChunkPos = this->ReadPos - this->pFront->GetLength();
+
+	this->StartRead();
+	return true;
+}
+
+const TBitField& TBitStreamReader::GetChunk() const // текущая порция
+{
+	return *this->pFront;
+}
+
+unsigned long long TBitStreamReader::GetChunkPos() const // номер первого бита текущей порции
+{
+	return this->ChunkPos;
+}
+
+// запись
+
+TBitStreamWriter::TBitStreamWriter(ostream& ostr, unsigned long long len, int chunkLen)
+	: Stream(ostr)
+	, BitLen(len)
+	, WritePos(0)
+	, ChunkLen(chunkLen)
+	, Buf0(_chunk_len_for(len, chunkLen))
+	, Buf1(_chunk_len_for(len, chunkLen))
+	, pFront(&Buf0)
+	, pBack(&Buf1)
+{
+	const std::uint64_t header = len;
+	this->Stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	this->PrepareChunk();
+}
+
+TBitStreamWriter::~TBitStreamWriter()
+{
+	if (this->Pending.valid()) {
+		this->Pending.wait();
+	}
+}
+
+void TBitStreamWriter::PrepareChunk() // подготовить pFront под следующую порцию
+{
+	if (this->IsFull()) return;
+
+	const int len = int(std::min<unsigned long long>(this->ChunkLen, this->BitLen - this->WritePos));
+	if (this->pFront->GetLength() != len) {
+		*this->pFront = TBitField(len);
+	}
+	else {
+		std::memset(this->pFront->GetMem(), 0, this->pFront->GetMemLen() * sizeof(TELEM));
+	}
+}
+
+unsigned long long TBitStreamWriter::GetLength() const // длина потока в битах
+{
+	return this->BitLen;
+}
+
+bool TBitStreamWriter::IsFull() const // все порции записаны
+{
+	return this->WritePos >= this->BitLen;
+}
+
+TBitField& TBitStreamWriter::GetChunk() // порция для заполнения
+{
+	if (this->IsFull()) {
+		throw std::out_of_range("bit stream is full");
+	}
+
+	return *this->pFront;
+}
+
+void TBitStreamWriter::Commit() // отдать порцию на запись
+{
+	if (this->IsFull()) {
+		throw std::out_of_range("bit stream is full");
+	}
+
+	if (this->Pending.valid()) {
+		this->Pending.get();
+	}
+
+	std::swap(this->pFront, this->pBack);
+	this->WritePos += this->pBack->GetLength();
+
+	const TBitField* pBuf = this->pBack;
+	this->Pending = std::async(std::launch::async, [this, pBuf] {
+		if (!this->Stream.write(reinterpret_cast<const char*>(pBuf->GetMem()), std::streamsize(pBuf->GetMemLen()) * sizeof(TELEM))) {
+			throw std::runtime_error("bit stream write failed");
+		}
+	});
+
+	this->PrepareChunk();
+}
+
+void TBitStreamWriter::Close() // дождаться окончания записи
+{
+	if (this->Pending.valid()) {
+		this->Pending.get();
+	}
+	if (!this->IsFull()) {
+		throw std::logic_error("bit stream is not complete");
+	}
+
+	this->Stream.flush();
+}
+
+// операции над потоками
+
+template <typename Op>
+static void _bitstream_apply(TBitStreamReader& a, TBitStreamReader& b, ostream& ostr, Op op)
+{
+	if (a.GetChunkLen() != b.GetChunkLen()) {
+		throw std::logic_error("different chunk lengths of bit streams");
+	}
+
+	TBitStreamWriter out(ostr, std::max(a.GetLength(), b.GetLength()), a.GetChunkLen());
+
+	bool hasA = a.Next(), hasB = b.Next();
+	while (!out.IsFull())
+	{
+		TBitField& chunk = out.GetChunk();
+		TELEM* res = chunk.GetMem();
+		const TELEM* pa = hasA ? a.GetChunk().GetMem() : nullptr;
+		const TELEM* pb = hasB ? b.GetChunk().GetMem() : nullptr;
+		const int lenA = hasA ? a.GetChunk().GetMemLen() : 0;
+		const int lenB = hasB ? b.GetChunk().GetMemLen() : 0;
+
+		for (int i = 0; i < chunk.GetMemLen(); i++)
+		{
+			res[i] = op(i < lenA ? pa[i] : TELEM(0), i < lenB ? pb[i] : TELEM(0));
+		}
+
+		out.Commit();
+		hasA = hasA && a.Next();
+		hasB = hasB && b.Next();
+	}
+
+	out.Close();
+}
+
+void BitStreamOr(TBitStreamReader& a, TBitStreamReader& b, ostream& ostr) // поток "или"
+{
+	_bitstream_apply(a, b, ostr, [](TELEM x, TELEM y) { return TELEM(x | y); });
+}
+
+void BitStreamAnd(TBitStreamReader& a, TBitStreamReader& b, ostream& ostr) // поток "и"
+{
+	_bitstream_apply(a, b, ostr, [](TELEM x, TELEM y) { return TELEM(x & y); });
+}
@@ -0,0 +1,284 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tblockmap.cpp
+//
+// Карта свободных блоков с поиском непрерывных участков
+
+#include "tblockmap.h"
+#include "tbitops.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+static const int BlockGroupBits = BlockGroupMemLen * TELEMBits;
+
+// длина участка единиц в x, начиная с младшего бита
+static int _ones_run(TELEM x)
+{
+	return ~x == 0 ? TELEMBits : _ctz(~x);
+}
+
+// маска битов [from, to) эл-та, 0 <= from < to <= TELEMBits
+static TELEM _range_mask(int from, int to)
+{
+	const TELEM high = to == TELEMBits ? TELEM(-1) : (TELEM(1) << to) - 1;
+	return high & ~((TELEM(1) << from) - 1);
+}
+
+TBlockMap::TBlockMap(int len)
+	: Used(len)
+	, FreeCount(len)
+{
+	this->WordRuns.resize(this->Used.GetMemLen());
+	this->GroupRuns.resize((this->Used.GetMemLen() + BlockGroupMemLen - 1) / BlockGroupMemLen);
+	this->UpdateRuns(0, this->Used.GetMemLen());
+}
+
+TELEM TBlockMap::GetWord(const int i) const // эл-т, биты за пределами длины - 1
+{
+	TELEM word = this->Used.GetMem()[i];
+	const int tail = this->Used.GetLength() - i * TELEMBits;
+	if (tail < TELEMBits) {
+		word |= ~_range_mask(0, tail);
+	}
+
+	return word;
+}
+
+void TBlockMap::UpdateRuns(const int from, const int to) // пересчитать сводки для эл-тов [from, to)
+{
+	for (int i = from; i < to; i++)
+	{
+		const TELEM word = this->GetWord(i);
+		TZeroRuns<unsigned char>& r = this->WordRuns[i];
+		r.Low = word == 0 ? TELEMBits : _ctz(word);
+		r.High = word == 0 ? TELEMBits : _clz(word);
+		r.Max = std::max(r.Low, r.High);
+		for (TELEM z = ~word; z != 0; )
+		{
+			const int s = _ctz(z), len = _ones_run(z >> s);
+			r.Max = std::max<int>(r.Max, len);
+			if (s + len == TELEMBits) break;
+			z &= ~_range_mask(s, s + len);
+		}
+	}
+
+	for (int g = from / BlockGroupMemLen; g * BlockGroupMemLen < to; g++)
+	{
+		const int first = g * BlockGroupMemLen;
+		const int last = std::min(first + BlockGroupMemLen, int(this->WordRuns.size()));
+		TZeroRuns<int>& r = this->GroupRuns[g];
+
+		r.Low = 0;
+		for (int i = first; i < last; i++)
+		{
+			r.Low += this->WordRuns[i].Low;
+			if (this->WordRuns[i].Low != TELEMBits) break;
+		}
+		r.High = 0;
+		for (int i = last - 1; i >= first; i--)
+		{
+			r.High += this->WordRuns[i].High;
+			if (this->WordRuns[i].High != TELEMBits) break;
+		}
+
+		int run = 0;
+		r.Max = 0;
+		for (int i = first; i < last; i++)
+		{
+			const TZeroRuns<unsigned char>& w = this->WordRuns[i];
+			if (w.Low == TELEMBits) {
+				run += TELEMBits;
+				continue;
+			}
+			r.Max = std::max({ r.Max, run + w.Low, int(w.Max) });
+			run = w.High;
+		}
+		r.Max = std::max(r.Max, run);
+	}
+}
+
+template <typename F>
+void TBlockMap::ForEachZeroRun(const int len, F f) const // перебор свободных участков не короче len
+{
+	int run = 0, runStart = 0; // участок, продолжающийся за текущую позицию
+
+	// участок продлен на extra свободных блоков и закрыт занятым
+	auto close = [&](int extra) { return run + extra >= len && f(runStart, run + extra); };
+
+	for (int g = 0; g < int(this->GroupRuns.size()); g++)
+	{
+		const TZeroRuns<int>& G = this->GroupRuns[g];
+		const int first = g * BlockGroupMemLen;
+		const int last = std::min(first + BlockGroupMemLen, int(this->WordRuns.size()));
+		const int gStart = first * TELEMBits, gEnd = last * TELEMBits;
+
+		if (G.Low == gEnd - gStart) { // группа свободна
+			if (run == 0) runStart = gStart;
+			run += G.Low;
+			continue;
+		}
+		if (G.Max < len) {            // внутри группы подходящих участков нет
+			if (run == 0) runStart = gStart;
+			if (close(G.Low)) return;
+			run = G.High;
+			runStart = gEnd - G.High;
+			continue;
+		}
+
+		for (int i = first; i < last; i++)
+		{
+			const TZeroRuns<unsigned char>& W = this->WordRuns[i];
+			const int wStart = i * TELEMBits;
+
+			if (W.Low == TELEMBits) {
+				if (run == 0) runStart = wStart;
+				run += TELEMBits;
+				continue;
+			}
+			if (run == 0) runStart = wStart;
+			if (W.Max < len) {
+				if (close(W.Low)) return;
+				run = W.High;
+				runStart = wStart + TELEMBits - W.High;
+				continue;
+			}
+
+			// участки внутри эл-та
+			if (close(W.Low)) return;
+			run = 0;
+			for (TELEM z = ~this->GetWord(i); z != 0; )
+			{
+				const int s = _ctz(z), n = _ones_run(z >> s);
+				if (s + n == TELEMBits) { // продолжается в следующем эл-те
+					if (s != 0) {
+						run = n;
+						runStart = wStart + s;
+					}
+					break;
+				}
+				if (s != 0 && n >= len && f(wStart + s, n)) return;
+				z &= ~_range_mask(s, s + n);
+			}
+		}
+	}
+
+	if (run >= len) {
+		f(runStart, run);
+	}
+}
+
+// доступ к блокам
+
+int TBlockMap::GetLength() const // к-во блоков
+{
+	return this->Used.GetLength();
+}
+
+int TBlockMap::GetFreeCount() const // к-во свободных блоков
+{
+	return this->FreeCount;
+}
+
+int TBlockMap::IsFree(const int n) const // блок свободен?
+{
+	return !this->Used.GetBit(n);
+}
+
+const TBitField& TBlockMap::GetBitField() const // карта занятых блоков
+{
+	return this->Used;
+}
+
+// поиск и выделение участков
+
+int TBlockMap::FindZeroRun(const int len, TBlockFit fit) const // начало свободного участка
+{
+	if (len <= 0) {
+		throw std::logic_error("run length must be positive");
+	}
+	if (len > this->FreeCount) return -1;
+
+	int start = -1, best = INT_MAX;
+	this->ForEachZeroRun(len, [&](int s, int n)
+	{
+		if (n < best) {
+			start = s;
+			best = n;
+		}
+		return fit == FitFirst || n == len;
+	});
+
+	return start;
+}
+
+int TBlockMap::Allocate(const int len, TBlockFit fit) // найти и занять участок
+{
+	const int start = this->FindZeroRun(len, fit);
+	if (start >= 0) {
+		this->FillRange(start, len, true);
+	}
+
+	return start;
+}
+
+void TBlockMap::CheckRange(const int start, const int len) const
+{
+	if (len <= 0 || start < 0 || start > this->Used.GetLength() - len) {
+		throw std::out_of_range("invalid arg");
+	}
+}
+
+void TBlockMap::FillRange(const int start, const int len, bool used)
+{
+	TELEM* mem = this->Used.GetMem();
+	const int end = start + len;
+	for (int i = start / TELEMBits; i * TELEMBits < end; i++)
+	{
+		const int from = std::max(start - i * TELEMBits, 0);
+		const int to = std::min(end - i * TELEMBits, TELEMBits);
+		if (used) {
+			mem[i] |= _range_mask(from, to);
+		}
+		else {
+			mem[i] &= ~_range_mask(from, to);
+		}
+	}
+
+	this->FreeCount += used ? -len : len;
+	this->UpdateRuns(start / TELEMBits, (end + TELEMBits - 1) / TELEMBits);
+}
+
+void TBlockMap::AllocateRange(const int start, const int len) // занять заданный участок
+{
+	this->CheckRange(start, len);
+
+	const TELEM* mem = this->Used.GetMem();
+	const int end = start + len;
+	for (int i = start / TELEMBits; i * TELEMBits < end; i++)
+	{
+		const TELEM mask = _range_mask(std::max(start - i * TELEMBits, 0), std::min(end - i * TELEMBits, TELEMBits));
+		if (mem[i] & mask) {
+			throw std::logic_error("blocks are already used");
+		}
+	}
+
+	this->FillRange(start, len, true);
+}
+
+void TBlockMap::FreeRange(const int start, const int len) // освободить участок
+{
+	this->CheckRange(start, len);
+
+	const TELEM* mem = this->Used.GetMem();
+	const int end = start + len;
+	for (int i = start / TELEMBits; i * TELEMBits < end; i++)
+	{
+		const TELEM mask = _range_mask(std::max(start - i * TELEMBits, 0), std::min(end - i * TELEMBits, TELEMBits));
+		if ((mem[i] & mask) != mask) {
+			throw std::logic_error("blocks are not used");
+		}
+	}
+
+	this->FillRange(start, len, false);
+}
@@ -0,0 +1,245 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tbulkops.cpp
+//
+// Параллельные массовые операции над битовыми полями и множествами
+
+#include "tbulkops.h"
+#include "tbitops.h"
+#include "tatomicbitfield.h"
+#include <algorithm>
+#include <stdexcept>
+
+static const int LineMemLen = CacheLineSize / sizeof(TELEM); // эл-тов в строке кэша
+
+// f(from, to) для участков [from, to) памяти из memLen эл-тов
+template <typename F>
+static void _for_chunks(int memLen, int threads, F f)
+{
+	threads = memLen < ParallelMinMemLen ? 1 : GetThreadCount(threads);
+	if (threads == 1) {
+		f(0, memLen);
+		return;
+	}
+
+	// по несколько участков на поток, границы - на строках кэша
+	int chunk = std::max(ParallelChunkMemLen, memLen / (4 * threads));
+	chunk = (chunk + LineMemLen - 1) / LineMemLen * LineMemLen;
+	const int chunks = (memLen + chunk - 1) / chunk;
+
+	ParallelFor(chunks, threads, [&](long long i)
+	{
+		const int from = int(i) * chunk;
+		f(from, std::min(from + chunk, memLen));
+	});
+}
+
+template <typename Op>
+static TBitField _apply(const TBitField& a, const TBitField& b, int threads, Op op)
+{
+	const TBitField& longer = a.GetLength() >= b.GetLength() ? a : b;
+	const TBitField& shorter = a.GetLength() >= b.GetLength() ? b : a;
+
+	TBitField res(longer.GetLength(), a.GetResource());
+	TELEM* r = res.GetMem();
+	const TELEM* pl = longer.GetMem();
+	const TELEM* ps = shorter.GetMem();
+	const int common = shorter.GetMemLen();
+
+	_for_chunks(res.GetMemLen(), threads, [=](int from, int to)
+	{
+		for (int i = from; i < to; i++)
+		{
+			r[i] = op(pl[i], i < common ? ps[i] : TELEM(0));
+		}
+	});
+
+	return res;
+}
+
+// битовые поля
+
+TBitField Union(const TBitField& a, const TBitField& b, int threads) // "или"
+{
+	return _apply(a, b, threads, [](TELEM x, TELEM y) { return TELEM(x | y); });
+}
+
+TBitField Intersection(const TBitField& a, const TBitField& b, int threads) // "и"
+{
+	return _apply(a, b, threads, [](TELEM x, TELEM y) { return TELEM(x & y); });
+}
+
+TBitField Complement(const TBitField& a, int threads) // отрицание
+{
+	TBitField res(a.GetLength(), a.GetResource());
+	TELEM* r = res.GetMem();
+	const TELEM* pa = a.GetMem();
+
+	_for_chunks(res.GetMemLen(), threads, [=](int from, int to)
+	{
+		for (int i = from; i < to; i++)
+		{
+			r[i] = ~pa[i];
+		}
+	});
+	if (a.GetLength() % TELEMBits != 0) {
+		r[res.GetMemLen() - 1] &= TELEM(-1) >> (TELEMBits - a.GetLength() % TELEMBits);
+	}
+
+	return res;
+}
+
+bool IsEqual(const TBitField& a, const TBitField& b, int threads) // сравнение
+{
+	if (&a == &b) return true;
+	if (a.GetLength() != b.GetLength()) return false;
+
+	const TELEM* pa = a.GetMem();
+	const TELEM* pb = b.GetMem();
+	std::atomic<bool> equal(true);
+
+	_for_chunks(a.GetMemLen(), threads, [&](int from, int to)
+	{
+		if (!equal.load(std::memory_order_relaxed)) return;
+		if (!std::equal(pa + from, pa + to, pb + from)) {
+			equal.store(false, std::memory_order_relaxed);
+		}
+	});
+
+	return equal;
+}
+
+long long PopCount(const TBitField& a, int threads) // к-во единиц
+{
+	const TELEM* pa = a.GetMem();
+	std::atomic<long long> count(0);
+
+	_for_chunks(a.GetMemLen(), threads, [&](int from, int to)
+	{
+		long long part = 0;
+		for (int i = from; i < to; i++)
+		{
+			part += _popcount(pa[i]);
+		}
+		count += part;
+	});
+
+	return count;
+}
+
+// множества
+
+TSet Union(const TSet& a, const TSet& b, int threads) // объединение
+{
+	return TSet(Union(a.GetBitField(), b.GetBitField(), threads));
+}
+
+TSet Intersection(const TSet& a, const TSet& b, int threads) // пересечение
+{
+	return TSet(Intersection(a.GetBitField(), b.GetBitField(), threads));
+}
+
+TSet Complement(const TSet& a, int threads) // дополнение
+{
+	return TSet(Complement(a.GetBitField(), threads));
+}
+
+bool IsEqual(const TSet& a, const TSet& b, int threads) // сравнение
+{
+	return IsEqual(a.GetBitField(), b.GetBitField(), threads);
+}
+
+long long PopCount(const TSet& a, int threads) // мощность
+{
+	return PopCount(a.GetBitField(), threads);
+}
+
+// свертка
+
+// acc = acc op bf, поле bf может быть короче acc
+static void _reduce_into(TBitField& acc, const TBitField& bf, TReduceOp op)
+{
+	TELEM* r = acc.GetMem();
+	const TELEM* p = bf.GetMem();
+	const int common = std::min(acc.GetMemLen(), bf.GetMemLen());
+
+	if (op == ReduceUnion) {
+		for (int i = 0; i < common; i++)
+		{
+			r[i] |= p[i];
+		}
+	}
+	else {
+		for (int i = 0; i < common; i++)
+		{
+			r[i] &= p[i];
+		}
+		std::fill(r + common, r + acc.GetMemLen(), TELEM(0));
+	}
+}
+
+TBitField _reduce(const TBitField* const* fields, long long count, TReduceOp op, int threads)
+{
+	if (count <= 0) {
+		throw std::logic_error("nothing to reduce");
+	}
+
+	int len = 0;
+	for (long long i = 0; i < count; i++)
+	{
+		len = std::max(len, fields[i]->GetLength());
+	}
+
+	// по одному накопителю на поток
+	threads = int(std::min<long long>(GetThreadCount(threads), count));
+	std::vector<TBitField> acc(threads, TBitField(0));
+	ParallelFor(threads, threads, [&](long long t)
+	{
+		const long long from = count * t / threads, to = count * (t + 1) / threads;
+		TBitField part(len, fields[0]->GetResource());
+		if (op == ReduceIntersection) {
+			part = ~part;
+		}
+		for (long long i = from; i < to; i++)
+		{
+			_reduce_into(part, *fields[i], op);
+		}
+		acc[t] = part;
+	});
+
+	// попарное слияние деревом
+	for (int step = 1; step < threads; step *= 2)
+	{
+		ParallelFor((threads + 2 * step - 1) / (2 * step), threads, [&](long long k)
+		{
+			const int i = int(k) * 2 * step;
+			if (i + step < threads) {
+				_reduce_into(acc[i], acc[i + step], op);
+			}
+		});
+	}
+
+	return acc[0];
+}
+
+TBitField Reduce(const TBitField* fields, long long count, TReduceOp op, int threads) // свертка полей
+{
+	std::vector<const TBitField*> ptrs(std::size_t(std::max(count, 0LL)));
+	for (long long i = 0; i < count; i++)
+	{
+		ptrs[i] = fields + i;
+	}
+
+	return _reduce(ptrs.data(), count, op, threads);
+}
+
+TSet Reduce(const TSet* sets, long long count, TReduceOp op, int threads) // свертка множеств
+{
+	std::vector<const TBitField*> ptrs(std::size_t(std::max(count, 0LL)));
+	for (long long i = 0; i < count; i++)
+	{
+		ptrs[i] = &sets[i].GetBitField();
+	}
+
+	return TSet(_reduce(ptrs.data(), count, op, threads));
+}
@@ -0,0 +1,244 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tconcurrentset.cpp
+//
+// Множество с одним писателем и читателями без блокировок
+
+#include "tconcurrentset.h"
+#include "tbitops.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+TConcurrentSet::TConcurrentSet(int mp)
+	: MaxPower(mp)
+	, ChunkMemLen(ConcurrentChunkLen / TELEMBits)
+	, pCurrent(nullptr)
+	, Epoch(1)
+{
+	this->Init(TBitField(mp));
+}
+
+TConcurrentSet::TConcurrentSet(const TSet& s)
+	: MaxPower(s.GetMaxPower())
+	, ChunkMemLen(ConcurrentChunkLen / TELEMBits)
+	, pCurrent(nullptr)
+	, Epoch(1)
+{
+	this->Init(s.GetBitField());
+}
+
+void TConcurrentSet::Init(const TBitField& bf) // первая версия
+{
+	for (int i = 0; i < ConcurrentMaxReaders; i++)
+	{
+		this->Slots[i].Epoch.store(0, std::memory_order_relaxed);
+	}
+
+	const int chunks = (bf.GetLength() + ConcurrentChunkLen - 1) / ConcurrentChunkLen;
+	TVersion* pVersion = new TVersion;
+	pVersion->Chunks.resize(chunks);
+	this->Pending.resize(chunks);
+	this->Dirty.assign(chunks, 0);
+
+	const TELEM* mem = bf.GetMem();
+	for (int c = 0; c < chunks; c++)
+	{
+		TELEM* chunk = new TELEM[this->ChunkMemLen]();
+		const int from = c * this->ChunkMemLen;
+		const int len = std::min(this->ChunkMemLen, bf.GetMemLen() - from);
+		std::memcpy(chunk, mem + from, len * sizeof(TELEM));
+		pVersion->Chunks[c] = chunk;
+		this->Pending[c] = chunk;
+	}
+
+	this->pCurrent.store(pVersion, std::memory_order_release);
+}
+
+TConcurrentSet::~TConcurrentSet()
+{
+	for (int c : this->DirtyChunks)
+	{
+		delete[] this->Pending[c];
+	}
+	for (const TRetired& r : this->Retired)
+	{
+		this->Free(r.pVersion, r.Chunks);
+	}
+
+	const TVersion* pVersion = this->pCurrent.load();
+	this->Free(pVersion, pVersion->Chunks);
+}
+
+void TConcurrentSet::Free(const TVersion* pVersion, const std::vector<const TELEM*>& chunks)
+{
+	for (const TELEM* chunk : chunks)
+	{
+		delete[] chunk;
+	}
+	delete pVersion;
+}
+
+int TConcurrentSet::GetMaxPower(void) const // получить макс. к-во эл-тов
+{
+	return this->MaxPower;
+}
+
+TConcurrentSet::TSnapshot TConcurrentSet::Snapshot(void) // снимок текущей версии
+{
+	return TSnapshot(*this);
+}
+
+// писатель
+
+TELEM* TConcurrentSet::WritableChunk(const int ElemIndex) // участок черновика для изменения
+{
+	if (ElemIndex < 0 || ElemIndex >= this->MaxPower) {
+		throw std::out_of_range("invalid arg");
+	}
+
+	const int c = ElemIndex / ConcurrentChunkLen;
+	if (!this->Dirty[c]) {
+		TELEM* copy = new TELEM[this->ChunkMemLen];
+		std::memcpy(copy, this->Pending[c], this->ChunkMemLen * sizeof(TELEM));
+		this->Replaced.push_back(this->Pending[c]);
+		this->Pending[c] = copy;
+		this->Dirty[c] = 1;
+		this->DirtyChunks.push_back(c);
+	}
+
+	return this->Pending[c];
+}
+
+void TConcurrentSet::InsElem(const int ElemIndex) // включение элемента в черновик
+{
+	TELEM* chunk = this->WritableChunk(ElemIndex);
+	const int n = ElemIndex % ConcurrentChunkLen;
+	chunk[n / TELEMBits] |= TELEM(1) << (n % TELEMBits);
+}
+
+void TConcurrentSet::DelElem(const int ElemIndex) // исключение элемента из черновика
+{
+	TELEM* chunk = this->WritableChunk(ElemIndex);
+	const int n = ElemIndex % ConcurrentChunkLen;
+	chunk[n / TELEMBits] &= ~(TELEM(1) << (n % TELEMBits));
+}
+
+void TConcurrentSet::Publish(void) // опубликовать черновик
+{
+	if (this->DirtyChunks.empty()) return;
+
+	TVersion* pVersion = new TVersion;
+	pVersion->Chunks.assign(this->Pending.begin(), this->Pending.end());
+
+	// читатель, отметивший эпоху после увеличения, увидит новую версию
+	const TVersion* pOld = this->pCurrent.exchange(pVersion, std::memory_order_seq_cst);
+	const unsigned long long epoch = this->Epoch.fetch_add(1, std::memory_order_seq_cst);
+	this->Retired.push_back(TRetired{ epoch, pOld, std::move(this->Replaced) });
+
+	this->Replaced.clear();
+	for (int c : this->DirtyChunks)
+	{
+		this->Dirty[c] = 0;
+	}
+	this->DirtyChunks.clear();
+
+	this->Reclaim();
+}
+
+int TConcurrentSet::Reclaim(void) // освободить ненужные версии
+{
+	unsigned long long minEpoch = ~0ull;
+	for (int i = 0; i < ConcurrentMaxReaders; i++)
+	{
+		const unsigned long long e = this->Slots[i].Epoch.load(std::memory_order_seq_cst);
+		if (e != 0) {
+			minEpoch = std::min(minEpoch, e);
+		}
+	}
+
+	auto keep = std::partition(this->Retired.begin(), this->Retired.end(),
+		[minEpoch](const TRetired& r) { return r.Epoch >= minEpoch; });
+	for (auto it = keep; it != this->Retired.end(); ++it)
+	{
+		this->Free(it->pVersion, it->Chunks);
+	}
+	this->Retired.erase(keep, this->Retired.end());
+
+	return int(this->Retired.size());
+}
+
+// снимок
+
+TConcurrentSet::TSnapshot::TSnapshot(TConcurrentSet& s)
+	: pSet(&s)
+	, Slot(-1)
+	, pVersion(nullptr)
+{
+	// свободная ячейка, начиная с закрепленной за потоком
+	thread_local const std::size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+	for (int i = int(hint % ConcurrentMaxReaders); ; i = (i + 1) % ConcurrentMaxReaders)
+	{
+		unsigned long long expected = 0;
+		const unsigned long long epoch = s.Epoch.load(std::memory_order_seq_cst);
+		if (s.Slots[i].Epoch.compare_exchange_strong(expected, epoch, std::memory_order_seq_cst)) {
+			this->Slot = i;
+			break;
+		}
+		if (i == int((hint + ConcurrentMaxReaders - 1) % ConcurrentMaxReaders)) {
+			std::this_thread::yield(); // все ячейки заняты
+		}
+	}
+
+	this->pVersion = s.pCurrent.load(std::memory_order_seq_cst);
+}
+
+TConcurrentSet::TSnapshot::TSnapshot(TSnapshot&& s)
+	: pSet(s.pSet)
+	, Slot(s.Slot)
+	, pVersion(s.pVersion)
+{
+	s.Slot = -1;
+	s.pVersion = nullptr;
+}
+
+TConcurrentSet::TSnapshot::~TSnapshot()
+{
+	if (this->Slot >= 0) {
+		this->pSet->Slots[this->Slot].Epoch.store(0, std::memory_order_release);
+	}
+}
+
+int TConcurrentSet::TSnapshot::GetMaxPower(void) const // получить макс. к-во эл-тов
+{
+	return this->pSet->MaxPower;
+}
+
+int TConcurrentSet::TSnapshot::IsMember(const int ElemIndex) const // элемент множества?
+{
+	if (ElemIndex < 0 || ElemIndex >= this->pSet->MaxPower) {
+		throw std::out_of_range("invalid arg");
+	}
+
+	const int n = ElemIndex % ConcurrentChunkLen;
+	const TELEM* chunk = this->pVersion->Chunks[ElemIndex / ConcurrentChunkLen];
+	return bool(chunk[n / TELEMBits] & (TELEM(1) << (n % TELEMBits)));
+}
+
+TSet TConcurrentSet::TSnapshot::ToSet(void) const // копия версии
+{
+	TBitField bf(this->pSet->MaxPower);
+	TELEM* mem = bf.GetMem();
+	const int memLen = bf.GetMemLen();
+	const int chunkMemLen = this->pSet->ChunkMemLen;
+
+	for (int c = 0; c < int(this->pVersion->Chunks.size()); c++)
+	{
+		const int from = c * chunkMemLen;
+		std::memcpy(mem + from, this->pVersion->Chunks[c], std::min(chunkMemLen, memLen - from) * sizeof(TELEM));
+	}
+
+	return TSet(bf);
+}
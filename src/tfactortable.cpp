@@ -0,0 +1,116 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tfactortable.cpp
+//
+// Таблица наименьших простых делителей и разложение на множители
+
+#include "tfactortable.h"
+#include <stdexcept>
+
+// результат разложения
+
+std::size_t TFactorization::GetCount() const // к-во разложенных чисел
+{
+	return this->Offsets.empty() ? 0 : this->Offsets.size() - 1;
+}
+
+std::size_t TFactorization::GetFactorCount(std::size_t i) const // к-во множителей i-го числа
+{
+	return this->Offsets.at(i + 1) - this->Offsets[i];
+}
+
+const std::uint32_t* TFactorization::GetFactors(std::size_t i) const // множители i-го числа
+{
+	return this->Factors.data() + this->Offsets.at(i);
+}
+
+// таблица
+
+TFactorTable::TFactorTable(std::uint32_t limit)
+	: Limit(limit)
+	, Spf(std::size_t(limit) / 2 + 1, 0)
+{
+	// линейное решето по нечетным числам: каждое составное i*p помечается
+	// ровно один раз своим НПД p <= НПД(i); p*p <= Limit, поэтому нужны
+	// только простые до sqrt(Limit)
+	std::vector<std::uint32_t> primes;
+	for (std::uint64_t i = 3; 3 * i <= limit; i += 2)
+	{
+		std::uint32_t s = this->Spf[i / 2];
+		if (s == 0) {
+			s = std::uint32_t(i);
+			if (i * i <= limit) {
+				primes.push_back(s);
+			}
+		}
+
+		for (std::uint32_t p : primes)
+		{
+			if (p > s || p * i > limit) break;
+			this->Spf[p * i / 2] = std::uint16_t(p);
+		}
+	}
+}
+
+std::uint32_t TFactorTable::GetLimit() const // верхняя граница
+{
+	return this->Limit;
+}
+
+bool TFactorTable::IsPrime(std::uint32_t n) const // n - простое
+{
+	if (n > this->Limit) {
+		throw std::out_of_range("number is out of factor table");
+	}
+	if (n < 3 || n % 2 == 0) return n == 2;
+
+	return this->Spf[n / 2] == 0;
+}
+
+std::uint32_t TFactorTable::SmallestFactor(std::uint32_t n) const // НПД числа n
+{
+	if (n < 2 || n > this->Limit) {
+		throw std::out_of_range("number is out of factor table");
+	}
+	if (n % 2 == 0) return 2;
+
+	const std::uint32_t s = this->Spf[n / 2];
+	return s == 0 ? n : s;
+}
+
+void TFactorTable::Factorize(std::uint32_t n, std::vector<std::uint32_t>& factors) const // разложение одного числа
+{
+	if (n > this->Limit) {
+		throw std::out_of_range("number is out of factor table");
+	}
+
+	for (; n > 1 && n % 2 == 0; n /= 2)
+	{
+		factors.push_back(2);
+	}
+	while (n > 1)
+	{
+		const std::uint32_t s = this->Spf[n / 2];
+		if (s == 0) {
+			factors.push_back(n);
+			break;
+		}
+
+		factors.push_back(s);
+		n /= s;
+	}
+}
+
+void TFactorTable::Factorize(const std::uint32_t* values, std::size_t count, TFactorization& res) const // пакетное разложение
+{
+	res.Factors.clear();
+	res.Offsets.clear();
+	res.Offsets.reserve(count + 1);
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		res.Offsets.push_back(res.Factors.size());
+		this->Factorize(values[i], res.Factors);
+	}
+	res.Offsets.push_back(res.Factors.size());
+}
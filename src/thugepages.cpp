@@ -0,0 +1,154 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// thugepages.cpp
+//
+// Ресурс памяти на больших (2 Мбайт) страницах для больших битовых полей
+
+#include "thugepages.h"
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+THugePageResource::THugePageResource(std::size_t threshold, bool hugeTLB, std::pmr::memory_resource* upstream)
+	: pUpstream(upstream)
+	, Threshold(threshold)
+	, UseHugeTLB(hugeTLB)
+	, Stats{}
+{
+}
+
+THugePageResource::~THugePageResource()
+{
+#ifndef _WIN32
+	for (const auto& region : this->Regions)
+	{
+		munmap(region.first, region.second.Size);
+	}
+#endif
+}
+
+std::size_t THugePageResource::GetThreshold() const // наименьшее выделение через mmap
+{
+	return this->Threshold;
+}
+
+void* THugePageResource::do_allocate(std::size_t bytes, std::size_t align)
+{
+#ifndef _WIN32
+	if (bytes >= this->Threshold && align <= HugePageSize) {
+		const std::size_t size = (bytes + HugePageSize - 1) / HugePageSize * HugePageSize;
+		char* p = nullptr;
+		bool hugeTLB = false, advised = false;
+
+#ifdef MAP_HUGETLB
+		if (this->UseHugeTLB) {
+			void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (addr != MAP_FAILED) {
+				p = static_cast<char*>(addr);
+				hugeTLB = true;
+			}
+		}
+#endif
+		if (p == nullptr) {
+			// с запасом на выравнивание, лишнее по краям возвращается
+			void* addr = mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (addr == MAP_FAILED) {
+				throw std::bad_alloc();
+			}
+			char* raw = static_cast<char*>(addr);
+			p = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(raw) + HugePageSize - 1) / HugePageSize * HugePageSize);
+			if (p != raw) {
+				munmap(raw, p - raw);
+			}
+			if (p + size != raw + size + HugePageSize) {
+				munmap(p + size, raw + HugePageSize - p);
+			}
+#ifdef MADV_HUGEPAGE
+			advised = madvise(p, size, MADV_HUGEPAGE) == 0;
+#endif
+		}
+
+		std::lock_guard<std::mutex> lock(this->Lock);
+		this->Regions[p] = TRegion{ size, hugeTLB };
+		this->Stats.MappedCount++;
+		this->Stats.MappedBytes += size;
+		this->Stats.AdvisedBytes += advised ? size : 0;
+		this->Stats.HugeTLBBytes += hugeTLB ? size : 0;
+		return p;
+	}
+#endif
+
+	void* p = this->pUpstream->allocate(bytes, align);
+	std::lock_guard<std::mutex> lock(this->Lock);
+	this->Stats.UpstreamCount++;
+	return p;
+}
+
+void THugePageResource::do_deallocate(void* p, std::size_t bytes, std::size_t align)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->Lock);
+		auto it = this->Regions.find(static_cast<char*>(p));
+		if (it != this->Regions.end()) {
+#ifndef _WIN32
+			munmap(it->first, it->second.Size);
+#endif
+			this->Regions.erase(it);
+			return;
+		}
+	}
+
+	this->pUpstream->deallocate(p, bytes, align);
+}
+
+bool THugePageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+THugePageStats THugePageResource::GetStats() const // статистика выделений
+{
+	std::lock_guard<std::mutex> lock(this->Lock);
+	THugePageStats stats = this->Stats;
+	stats.HugeBytes = 0;
+
+	// участки hugetlbfs целиком на больших страницах, для остальных -
+	// AnonHugePages из описаний отображений, пересекающихся с участками
+	std::ifstream smaps("/proc/self/smaps");
+	std::string line;
+	bool inRegion = false;
+	while (std::getline(smaps, line))
+	{
+		unsigned long long from = 0, to = 0;
+		char dash = 0;
+		std::istringstream header(line);
+		if (header >> std::hex >> from >> dash >> to && dash == '-') {
+			// последний участок, начинающийся до конца отображения
+			auto it = this->Regions.lower_bound(reinterpret_cast<char*>(to));
+			inRegion = false;
+			if (it != this->Regions.begin()) {
+				--it;
+				inRegion = !it->second.HugeTLB && reinterpret_cast<std::uintptr_t>(it->first) + it->second.Size > from;
+			}
+			continue;
+		}
+		if (inRegion && line.compare(0, 14, "AnonHugePages:") == 0) {
+			stats.HugeBytes += std::stoll(line.substr(14)) * 1024;
+		}
+	}
+
+	for (const auto& region : this->Regions)
+	{
+		if (region.second.HugeTLB) {
+			stats.HugeBytes += region.second.Size;
+		}
+	}
+
+	return stats;
+}
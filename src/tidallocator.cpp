@@ -0,0 +1,158 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tidallocator.cpp
+//
+// Выдача и возврат номеров (идентификаторов) без блокировок
+
+#include "tidallocator.h"
+#include "tbitops.h"
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+// эл-т, с которого поток начинает поиск, - отдельно для каждого
+// распределителя; слоты выбираются по адресу распределителя
+const int SearchHintSlots = 8;
+
+struct _search_hint
+{
+	const TIdAllocator* Owner;
+	unsigned int Word;
+};
+
+static thread_local _search_hint SearchHints[SearchHintSlots];
+
+static unsigned int& _search_hint_for(const TIdAllocator* owner)
+{
+	_search_hint& hint = SearchHints[(reinterpret_cast<std::uintptr_t>(owner) / alignof(TIdAllocator)) % SearchHintSlots];
+	if (hint.Owner != owner) {
+		hint.Owner = owner;
+		hint.Word = unsigned(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	}
+
+	return hint.Word;
+}
+
+TIdAllocator::TIdAllocator(int len)
+	: Bits(len)
+	, Summary((len + TELEMBits - 1) / TELEMBits)
+	, WordCount((len + TELEMBits - 1) / TELEMBits)
+{
+}
+
+TELEM TIdAllocator::WordMask(const int w) const // допустимые биты эл-та w
+{
+	const int tail = this->Bits.GetLength() - w * TELEMBits;
+	return tail >= TELEMBits ? TELEM(-1) : TELEM(-1) >> (TELEMBits - tail);
+}
+
+void TIdAllocator::MarkFull(const int w) // отметить заполненный эл-т в сводке
+{
+	// номер мог освободиться до установки бита сводки
+	this->Summary.SetBit(w);
+	if (this->Bits.LoadWord(w) != this->WordMask(w)) {
+		this->Summary.ClrBit(w);
+	}
+}
+
+int TIdAllocator::AcquireInWord(const int w, int count, int* ids) // занять до count номеров в эл-те w
+{
+	const TELEM full = this->WordMask(w);
+	TELEM cur = this->Bits.LoadWord(w, std::memory_order_relaxed);
+	while (cur != full)
+	{
+		// младшие свободные биты, не больше count
+		TELEM take = 0, free = ~cur & full;
+		for (int i = 0; i < count && free != 0; i++)
+		{
+			const TELEM low = free & (TELEM(0) - free);
+			take |= low;
+			free ^= low;
+		}
+
+		if (this->Bits.CompareExchangeWord(w, cur, cur | take)) {
+			if ((cur | take) == full) {
+				this->MarkFull(w);
+			}
+
+			int n = 0;
+			for (; take != 0; take &= take - 1)
+			{
+				ids[n++] = w * TELEMBits + _ctz(take);
+			}
+			return n;
+		}
+	}
+
+	this->MarkFull(w);
+	return 0;
+}
+
+int TIdAllocator::GetLength() const // к-во номеров
+{
+	return this->Bits.GetLength();
+}
+
+int TIdAllocator::IsAcquired(const int id) const // номер занят?
+{
+	return this->Bits.GetBit(id);
+}
+
+int TIdAllocator::Acquire() // занять номер
+{
+	int id = -1;
+	this->AcquireN(1, &id);
+
+	return id;
+}
+
+int TIdAllocator::AcquireN(int count, int* ids) // занять до count номеров
+{
+	if (count < 0) {
+		throw std::logic_error("negative count");
+	}
+	if (this->WordCount == 0) return 0;
+
+	unsigned int& hint = _search_hint_for(this);
+	const int start = int(hint % unsigned(this->WordCount));
+	int done = 0;
+	for (int pass = 0; pass < 2 && done < count; pass++)
+	{
+		// первый проход - по сводке, второй - по всем эл-там
+		for (int k = 0; k < this->WordCount && done < count; )
+		{
+			const int w = (start + k) % this->WordCount;
+			if (pass == 0) {
+				const TELEM s = this->Summary.LoadWord(w / TELEMBits) >> (w % TELEMBits);
+				if (s & 1) {
+					k += _ctz(~s); // заполненные эл-ты подряд
+					continue;
+				}
+			}
+
+			const int n = this->AcquireInWord(w, count - done, ids + done);
+			if (n > 0) {
+				hint = unsigned(w);
+				done += n;
+			}
+			else {
+				k++;
+			}
+		}
+	}
+
+	return done;
+}
+
+void TIdAllocator::Release(const int id) // вернуть номер
+{
+	if (!this->Bits.TestAndClear(id)) {
+		throw std::logic_error("id is not acquired");
+	}
+
+	const int w = id / TELEMBits;
+	if (this->Summary.GetBit(w)) {
+		this->Summary.ClrBit(w);
+	}
+}
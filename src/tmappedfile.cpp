@@ -0,0 +1,110 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tmappedfile.cpp
+//
+// Файл, отображенный в память только для чтения
+
+#include "tmappedfile.h"
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+TMappedFile::TMappedFile(const char* path)
+	: pData(nullptr)
+	, Size(0)
+	, hFile(INVALID_HANDLE_VALUE)
+	, hMapping(nullptr)
+{
+	this->hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (this->hFile == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error(std::string("cannot open ") + path);
+	}
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(this->hFile, &size);
+	this->Size = std::size_t(size.QuadPart);
+
+	if (this->Size > 0) {
+		this->hMapping = CreateFileMappingA(this->hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (this->hMapping != nullptr) {
+			this->pData = static_cast<const char*>(MapViewOfFile(this->hMapping, FILE_MAP_READ, 0, 0, 0));
+		}
+		if (this->pData == nullptr) {
+			this->~TMappedFile();
+			throw std::runtime_error(std::string("cannot map ") + path);
+		}
+	}
+}
+
+TMappedFile::~TMappedFile()
+{
+	if (this->pData != nullptr) UnmapViewOfFile(this->pData);
+	if (this->hMapping != nullptr) CloseHandle(this->hMapping);
+	if (this->hFile != INVALID_HANDLE_VALUE) CloseHandle(this->hFile);
+
+	this->pData = nullptr;
+	this->hMapping = nullptr;
+	this->hFile = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+TMappedFile::TMappedFile(const char* path)
+	: pData(nullptr)
+	, Size(0)
+{
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error(std::string("cannot open ") + path);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw std::runtime_error(std::string("cannot stat ") + path);
+	}
+	this->Size = std::size_t(st.st_size);
+
+	if (this->Size > 0) {
+		void* addr = mmap(nullptr, this->Size, PROT_READ, MAP_SHARED, fd, 0);
+		if (addr == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error(std::string("cannot map ") + path);
+		}
+		this->pData = static_cast<const char*>(addr);
+	}
+
+	// отображение остается действительным и после закрытия файла
+	close(fd);
+}
+
+TMappedFile::~TMappedFile()
+{
+	if (this->pData != nullptr) {
+		munmap(const_cast<char*>(this->pData), this->Size);
+	}
+}
+
+#endif
+
+const char* TMappedFile::GetData() const // содержимое файла
+{
+	return this->pData;
+}
+
+std::size_t TMappedFile::GetSize() const // размер файла
+{
+	return this->Size;
+}
@@ -0,0 +1,309 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tprimeset.cpp
+//
+// Множество простых чисел с ленивым расширением границы
+
+#include "tprimeset.h"
+#include "tsieve.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+static const long long PrimeMaxBits = INT_MAX / PrimeBlockLen * PrimeBlockLen;
+
+TPrimeSet::TPrimeSet(long long limit)
+	: Bits(0)
+	, Prefix(1, 0)
+	, Words(Bits)
+	, pPrefix(Prefix.data())
+{
+	this->Extend(std::max(limit, 2ll));
+}
+
+long long TPrimeSet::GetLimit() const // граница просеянной части
+{
+	return 2ll * this->Words.GetLength() - 1;
+}
+
+void TPrimeSet::Extend(long long n) // обеспечить покрытие чисел до n
+{
+	if (n <= this->GetLimit()) return;
+
+	// длина кратна блоку, граница растет не менее чем вдвое
+	long long bits = std::max((n + 1) / 2 + 1, 2ll * this->Words.GetLength());
+	bits = (bits + PrimeBlockLen - 1) / PrimeBlockLen * PrimeBlockLen;
+	if (bits > PrimeMaxBits) {
+		if ((n + 1) / 2 + 1 > PrimeMaxBits) {
+			throw std::length_error("prime set limit is too large");
+		}
+		bits = PrimeMaxBits;
+	}
+
+	this->Reserve(bits);
+}
+
+void TPrimeSet::Reserve(long long bits) // увеличить к-во битов, досеять новую часть
+{
+	const int oldLen = this->Words.GetLength();
+
+	TBitField temp(static_cast<int>(bits));
+	std::copy(this->Words.GetMem(), this->Words.GetMem() + this->Words.GetMemLen(), temp.GetMem());
+	if (this->pMapping) {
+		this->Prefix.assign(this->pPrefix, this->pPrefix + oldLen / PrimeBlockLen + 1);
+	}
+
+	TSegmentedSieve sieve(2 * bits - 1, SieveSegmentLen, WheelOdd);
+	TELEM* mem = temp.GetMem();
+	sieve.ForEachSegment(oldLen, bits, [mem](long long low, const TBitField& window)
+	{
+		std::copy(window.GetMem(), window.GetMem() + window.GetMemLen(), mem + low / TELEMBits);
+	});
+	this->Bits = temp;
+
+	// префиксные суммы для новых блоков
+	long long count = this->Prefix.back();
+	for (long long b = oldLen / PrimeBlockLen; b < bits / PrimeBlockLen; b++)
+	{
+		for (int i = 0; i < PrimeBlockLen / TELEMBits; i++)
+		{
+			count += _popcount(mem[b * (PrimeBlockLen / TELEMBits) + i]);
+		}
+		this->Prefix.push_back(count);
+	}
+
+	this->Words = TBitFieldView(this->Bits);
+	this->pPrefix = this->Prefix.data();
+	this->pMapping.reset();
+}
+
+bool TPrimeSet::IsPrime(long long n) // n - простое
+{
+	if (n < 3) return n == 2;
+	if (n % 2 == 0) return false;
+
+	this->Extend(n);
+	return this->Words.GetBit(int(n / 2));
+}
+
+long long TPrimeSet::PrimePi(long long n) // к-во простых, не превосходящих n
+{
+	if (n < 2) return 0;
+	this->Extend(n);
+
+	// биты [0, end) - нечетные числа до n
+	const long long end = (n + 1) / 2;
+	const long long block = end / PrimeBlockLen;
+	const TELEM* mem = this->Words.GetMem();
+
+	long long count = 1 + this->pPrefix[block]; // 2 и полные блоки
+	long long w = block * (PrimeBlockLen / TELEMBits);
+	for (; (w + 1) * TELEMBits <= end; w++)
+	{
+		count += _popcount(mem[w]);
+	}
+	if (end % TELEMBits != 0) {
+		count += _popcount(mem[w] & (TELEM(-1) >> (TELEMBits - end % TELEMBits)));
+	}
+
+	return count;
+}
+
+long long TPrimeSet::NthPrime(long long k) // k-е простое
+{
+	if (k < 1) {
+		throw std::out_of_range("prime number index must be positive");
+	}
+	if (k == 1) return 2;
+
+	// нужно (k-1)-е нечетное простое; p_k < k (ln k + ln ln k) при k >= 6
+	const long long rank = k - 1;
+	const long long* prefixEnd = this->pPrefix + this->Words.GetLength() / PrimeBlockLen;
+	if (*prefixEnd < rank) {
+		const double lk = std::log(double(std::max(k, 6ll)));
+		this->Extend((long long)(k * (lk + std::log(lk))) + 1);
+	}
+	while (this->pPrefix[this->Words.GetLength() / PrimeBlockLen] < rank)
+	{
+		this->Extend(2 * this->GetLimit());
+	}
+
+	prefixEnd = this->pPrefix + this->Words.GetLength() / PrimeBlockLen;
+	const long long block = std::lower_bound(this->pPrefix, prefixEnd + 1, rank) - this->pPrefix - 1;
+	long long left = rank - this->pPrefix[block];
+	const TELEM* mem = this->Words.GetMem();
+	for (long long w = block * (PrimeBlockLen / TELEMBits);; w++)
+	{
+		const int count = _popcount(mem[w]);
+		if (left > count) {
+			left -= count;
+			continue;
+		}
+
+		TELEM word = mem[w];
+		while (--left > 0)
+		{
+			word &= word - 1;
+		}
+		return 2 * (w * TELEMBits + _ctz(word)) + 1;
+	}
+}
+
+long long TPrimeSet::NextPrime(long long n) // наименьшее простое, большее n
+{
+	if (n < 2) return 2;
+
+	for (long long bit = (n + 1) / 2;; )
+	{
+		this->Extend(2 * bit + 1);
+
+		const TELEM* mem = this->Words.GetMem();
+		const long long words = this->Words.GetMemLen();
+		TELEM word = mem[bit / TELEMBits] & (TELEM(-1) << (bit % TELEMBits));
+		for (long long w = bit / TELEMBits; w < words; word = ++w < words ? mem[w] : 0)
+		{
+			if (word != 0) {
+				return 2 * (w * TELEMBits + _ctz(word)) + 1;
+			}
+		}
+
+		bit = this->Words.GetLength();
+	}
+}
+
+long long TPrimeSet::PrevPrime(long long n) // наибольшее простое, меньшее n
+{
+	if (n <= 2) {
+		throw std::out_of_range("there is no prime less than 2");
+	}
+	this->Extend(n - 1);
+
+	// бит наибольшего нечетного числа, меньшего n
+	const long long bit = (n % 2 == 0 ? n - 1 : n - 2) / 2;
+	const TELEM* mem = this->Words.GetMem();
+	if (bit >= 0) {
+		TELEM word = mem[bit / TELEMBits] & (TELEM(-1) >> (TELEMBits - 1 - bit % TELEMBits));
+		for (long long w = bit / TELEMBits; w >= 0; word = --w >= 0 ? mem[w] : 0)
+		{
+			if (word != 0) {
+				return 2 * (w * TELEMBits + TELEMBits - 1 - _clz(word)) + 1;
+			}
+		}
+	}
+
+	return 2;
+}
+
+std::vector<long long> TPrimeSet::GetPrimes(long long from, long long to) // простые из [from, to]
+{
+	std::vector<long long> primes;
+	this->ForEachPrime(from, to, [&primes](long long p) { primes.push_back(p); });
+
+	return primes;
+}
+
+// сохранение и отображение
+
+static const char PrimeSetMagic[8] = { 'T', 'P', 'R', 'I', 'M', 'E', 'S', 0 };
+static const std::uint32_t PrimeSetVersion = 1;
+
+struct _primeset_header
+{
+	char Magic[8];
+	std::uint32_t Version;
+	std::uint32_t BlockLen;   // PrimeBlockLen при сохранении
+	std::uint64_t BitLen;     // к-во битов (граница - 2 * BitLen - 1)
+	std::uint64_t Checksum;   // сумма битов и префиксных сумм
+	std::uint64_t Reserved[4];
+};
+
+// пословная контрольная сумма в духе FNV-1a
+static std::uint64_t _checksum(std::uint64_t hash, const void* data, std::size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	for (std::size_t i = 0; i + sizeof(std::uint32_t) <= size; i += sizeof(std::uint32_t))
+	{
+		std::uint32_t word;
+		std::memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ word) * 1099511628211ull;
+	}
+
+	return hash;
+}
+
+static std::uint64_t _checksum(const TBitFieldView& words, const long long* prefix)
+{
+	const std::size_t prefixLen = std::size_t(words.GetLength() / PrimeBlockLen + 1);
+	std::uint64_t hash = 14695981039346656037ull;
+	hash = _checksum(hash, words.GetMem(), std::size_t(words.GetMemLen()) * sizeof(TELEM));
+	hash = _checksum(hash, prefix, prefixLen * sizeof(long long));
+
+	return hash;
+}
+
+void TPrimeSet::Save(const char* path) const // сохранить просеянное множество
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throw std::runtime_error(std::string("cannot create ") + path);
+	}
+
+	_primeset_header header{};
+	std::memcpy(header.Magic, PrimeSetMagic, sizeof(PrimeSetMagic));
+	header.Version = PrimeSetVersion;
+	header.BlockLen = PrimeBlockLen;
+	header.BitLen = std::uint64_t(this->Words.GetLength());
+	header.Checksum = _checksum(this->Words, this->pPrefix);
+
+	// длина битов кратна блоку, поэтому префиксные суммы выровнены на 8 байт
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(this->Words.GetMem()), std::streamsize(this->Words.GetMemLen()) * sizeof(TELEM));
+	file.write(reinterpret_cast<const char*>(this->pPrefix), std::streamsize(this->Words.GetLength() / PrimeBlockLen + 1) * sizeof(long long));
+
+	if (!file.flush()) {
+		throw std::runtime_error(std::string("cannot write ") + path);
+	}
+}
+
+void TPrimeSet::Open(const char* path, bool verify) // отобразить сохраненное множество
+{
+	std::unique_ptr<TMappedFile> mapping(new TMappedFile(path));
+
+	_primeset_header header;
+	if (mapping->GetSize() < sizeof(header)) {
+		throw std::runtime_error(std::string("bad prime set file ") + path);
+	}
+	std::memcpy(&header, mapping->GetData(), sizeof(header));
+
+	const std::uint64_t wordsSize = header.BitLen / TELEMBits * sizeof(TELEM);
+	const std::uint64_t prefixSize = (header.BitLen / PrimeBlockLen + 1) * sizeof(long long);
+	if (std::memcmp(header.Magic, PrimeSetMagic, sizeof(PrimeSetMagic)) != 0 ||
+		header.Version != PrimeSetVersion || header.BlockLen != PrimeBlockLen ||
+		header.BitLen % PrimeBlockLen != 0 || header.BitLen > std::uint64_t(PrimeMaxBits) ||
+		mapping->GetSize() != sizeof(header) + wordsSize + prefixSize) {
+		throw std::runtime_error(std::string("bad prime set file ") + path);
+	}
+
+	const char* data = mapping->GetData() + sizeof(header);
+	const TBitFieldView words(reinterpret_cast<const TELEM*>(data), int(header.BitLen));
+	const long long* prefix = reinterpret_cast<const long long*>(data + wordsSize);
+	if (verify && _checksum(words, prefix) != header.Checksum) {
+		throw std::runtime_error(std::string("prime set checksum mismatch in ") + path);
+	}
+
+	this->Words = words;
+	this->pPrefix = prefix;
+	this->pMapping = std::move(mapping);
+	this->Bits = TBitField(0);
+	this->Prefix.assign(1, 0);
+}
+
+bool TPrimeSet::IsMapped() const // данные в отображенном файле
+{
+	return bool(this->pMapping);
+}
@@ -6,12 +6,17 @@
 // Множество - реализация через битовые поля
 
 #include "tset.h"
+#include "tbitops.h"
+#include "tvarint.h"
 #include <string>
 #include <vector>
 #include <execution>
+#include <cstdint>
+#include <climits>
+#include <stdexcept>
 
 
-TSet::TSet(int mp) : BitField(mp), MaxPower(0)
+TSet::TSet(int mp, std::pmr::memory_resource* mr) : BitField(mp, mr), MaxPower(0)
 {
 }
 
@@ -20,6 +25,11 @@ TSet::TSet(const TSet& s) : BitField(s.BitField), MaxPower(0)
 {
 }
 
+// копия в памяти из mr
+TSet::TSet(const TSet& s, std::pmr::memory_resource* mr) : BitField(s.BitField, mr), MaxPower(0)
+{
+}
+
 // конструктор преобразования типа
 TSet::TSet(const TBitField& bf) : BitField(bf), MaxPower(0)
 {
@@ -30,6 +40,16 @@ TSet::operator TBitField()
 	return this->BitField;
 }
 
+const TBitField& TSet::GetBitField(void) const // характеристический вектор
+{
+	return this->BitField;
+}
+
+std::pmr::memory_resource* TSet::GetResource(void) const // откуда выделена память
+{
+	return this->BitField.GetResource();
+}
+
 int TSet::GetMaxPower(void) const // получить макс. к-во эл-тов
 {
 	return this->BitField.GetLength();
@@ -131,8 +151,9 @@ istream& operator>>(istream& istr, TSet& s) // ввод
 		}
 	}
 
+	std::pmr::memory_resource* mr = s.GetResource();
 	s.~TSet();
-	new (&s) TSet(indexs.size());
+	new (&s) TSet(indexs.size(), mr);
 	for (auto elem : indexs)
 	{
 		s.BitField.SetBit(elem);
@@ -154,3 +175,106 @@ ostream& operator<<(ostream& ostr, const TSet& s) // вывод
 
 	return ostr;
 }
+
+// двоичный ввод/вывод
+
+static const std::uint8_t SetDense = 0;             // плотное представление
+static const std::uint8_t SetSparse = 1;            // разреженное представление
+static const std::size_t SparseBlockLen = 1024;     // к-во разностей в блоке
+
+void TSet::Save(ostream& ostr) const // запись в двоичном виде
+{
+	const TELEM* mem = this->BitField.GetMem();
+	const int memLen = this->BitField.GetMemLen();
+	const long long count = this->BitField.GetCount();
+
+	// разреженная запись занимает не более 5 байт на элемент
+	if (5 * count >= (long long)memLen * (long long)sizeof(TELEM)) {
+		ostr.put(char(SetDense));
+		this->BitField.Save(ostr);
+		return;
+	}
+
+	ostr.put(char(SetSparse));
+	const std::uint64_t header[2] = { std::uint64_t(this->BitField.GetLength()), std::uint64_t(count) };
+	ostr.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+	std::uint32_t block[SparseBlockLen];
+	std::uint8_t control[SparseBlockLen / 4];
+	std::uint8_t data[4 * SparseBlockLen];
+	std::size_t blockLen = 0;
+	auto flush = [&]() {
+		const std::size_t dataLen = StreamVByteEncode(block, blockLen, control, data);
+		ostr.write(reinterpret_cast<const char*>(control), StreamVByteControlLen(blockLen));
+		ostr.write(reinterpret_cast<const char*>(data), dataLen);
+		blockLen = 0;
+	};
+
+	std::uint32_t prev = 0;
+	for (int i = 0; i < memLen; i++)
+	{
+		for (TELEM word = mem[i]; word != 0; word &= word - 1)
+		{
+			const std::uint32_t elem = std::uint32_t(i) * TELEMBits + _ctz(word);
+			block[blockLen++] = elem - prev;
+			prev = elem;
+
+			if (blockLen == SparseBlockLen) {
+				flush();
+			}
+		}
+	}
+	if (blockLen > 0) {
+		flush();
+	}
+}
+
+void TSet::Load(istream& istr) // чтение из двоичного вида
+{
+	const int tag = istr.get();
+	if (tag == SetDense) {
+		this->BitField.Load(istr);
+		return;
+	}
+	if (tag != SetSparse) {
+		throw std::runtime_error("bad set header");
+	}
+
+	std::uint64_t header[2];
+	if (!istr.read(reinterpret_cast<char*>(header), sizeof(header))) {
+		throw std::runtime_error("bad set header");
+	}
+	if (header[0] > INT_MAX || header[1] > header[0]) {
+		throw std::length_error("bad set size");
+	}
+
+	const std::uint64_t maxPower = header[0];
+	this->BitField = TBitField(int(maxPower), this->BitField.GetResource());
+	TELEM* mem = this->BitField.GetMem();
+
+	std::uint8_t control[SparseBlockLen / 4];
+	std::uint8_t data[4 * SparseBlockLen];
+	std::uint64_t elem = 0;
+	for (std::uint64_t left = header[1]; left > 0;)
+	{
+		const std::size_t blockLen = std::size_t(std::min<std::uint64_t>(left, SparseBlockLen));
+		const std::size_t controlLen = StreamVByteControlLen(blockLen);
+		if (!istr.read(reinterpret_cast<char*>(control), controlLen)) {
+			throw std::runtime_error("truncated set data");
+		}
+		if (!istr.read(reinterpret_cast<char*>(data), StreamVByteDataLen(control, blockLen))) {
+			throw std::runtime_error("truncated set data");
+		}
+
+		// элементы сразу заносятся в битовое поле
+		StreamVByteDecode(control, data, blockLen, [&](std::uint32_t gap) {
+			elem += gap;
+			if (elem >= maxPower) {
+				throw std::out_of_range("set element out of range");
+			}
+			mem[elem / TELEMBits] |= TELEM(1) << (elem % TELEMBits);
+		});
+
+		left -= blockLen;
+	}
+}
@@ -0,0 +1,199 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tsetarchive.cpp
+//
+// Архив множеств с таблицей смещений для произвольного доступа
+
+#include "tsetarchive.h"
+#include "tbitops.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <stdexcept>
+#include <string>
+
+static const char ArchiveMagic[8] = { 'T', 'S', 'E', 'T', 'A', 'R', 'C', 'H' };
+static const std::uint32_t ArchiveVersion = 1;
+
+struct _archive_header
+{
+	char Magic[8];
+	std::uint32_t Version;
+	std::uint32_t Reserved;
+	std::uint64_t Count;
+	std::uint64_t TableOffset;
+};
+
+// запись
+
+TSetArchiveWriter::TSetArchiveWriter(const char* path)
+	: File(path, std::ios::binary | std::ios::trunc)
+	, Closed(false)
+{
+	if (!this->File) {
+		throw std::runtime_error(std::string("cannot create ") + path);
+	}
+
+	const _archive_header header{};
+	this->File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+TSetArchiveWriter::~TSetArchiveWriter()
+{
+	if (!this->Closed) {
+		try {
+			this->Close();
+		}
+		catch (...)
+		{}
+	}
+}
+
+void TSetArchiveWriter::Add(unsigned long long id, const TBitField& bf) // добавить запись
+{
+	if (this->Closed) {
+		throw std::logic_error("archive is closed");
+	}
+
+	std::uint64_t offset = std::uint64_t(this->File.tellp());
+	while (offset % 8 != 0)
+	{
+		this->File.put(0);
+		offset++;
+	}
+
+	bf.Save(this->File);
+	const std::uint64_t size = std::uint64_t(this->File.tellp()) - offset;
+
+	this->Table.push_back({ id, offset, size });
+}
+
+void TSetArchiveWriter::Close() // записать таблицу и заголовок
+{
+	if (this->Closed) return;
+	this->Closed = true;
+
+	std::sort(this->Table.begin(), this->Table.end(),
+		[](const TSetArchiveEntry& a, const TSetArchiveEntry& b) { return a.Id < b.Id; });
+	if (std::adjacent_find(this->Table.begin(), this->Table.end(),
+		[](const TSetArchiveEntry& a, const TSetArchiveEntry& b) { return a.Id == b.Id; }) != this->Table.end()) {
+		throw std::logic_error("duplicate set id in archive");
+	}
+
+	_archive_header header{};
+	std::memcpy(header.Magic, ArchiveMagic, sizeof(ArchiveMagic));
+	header.Version = ArchiveVersion;
+	header.Count = this->Table.size();
+	header.TableOffset = std::uint64_t(this->File.tellp());
+
+	for (const auto& entry : this->Table)
+	{
+		const std::uint64_t record[3] = { entry.Id, entry.Offset, entry.Size };
+		this->File.write(reinterpret_cast<const char*>(record), sizeof(record));
+	}
+
+	this->File.seekp(0);
+	this->File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	this->File.close();
+
+	if (!this->File) {
+		throw std::runtime_error("archive write failed");
+	}
+}
+
+// чтение
+
+TSetArchiveReader::TSetArchiveReader(const char* path)
+	: Path(path)
+	, File(path, std::ios::binary)
+{
+	if (!this->File) {
+		throw std::runtime_error(std::string("cannot open ") + path);
+	}
+
+	_archive_header header;
+	if (!this->File.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		std::memcmp(header.Magic, ArchiveMagic, sizeof(ArchiveMagic)) != 0 ||
+		header.Version != ArchiveVersion) {
+		throw std::runtime_error(std::string("bad archive header in ") + path);
+	}
+
+	// таблица должна умещаться в файле, иначе Count из поврежденного
+	// заголовка может потребовать огромного объема памяти
+	typedef std::uint64_t _table_record[3];
+	this->File.seekg(0, std::ios::end);
+	const std::uint64_t fileSize = std::uint64_t(this->File.tellg());
+	if (header.TableOffset < sizeof(header) || header.TableOffset > fileSize ||
+		header.Count > (fileSize - header.TableOffset) / sizeof(_table_record)) {
+		throw std::runtime_error(std::string("bad archive header in ") + path);
+	}
+
+	this->File.seekg(std::streamoff(header.TableOffset));
+	this->Table.resize(std::size_t(header.Count));
+	for (auto& entry : this->Table)
+	{
+		_table_record record;
+		if (!this->File.read(reinterpret_cast<char*>(record), sizeof(record))) {
+			throw std::runtime_error(std::string("truncated archive table in ") + path);
+		}
+		entry = { record[0], record[1], record[2] };
+	}
+}
+
+const TSetArchiveEntry& TSetArchiveReader::Find(unsigned long long id) const
+{
+	auto it = std::lower_bound(this->Table.begin(), this->Table.end(), id,
+		[](const TSetArchiveEntry& entry, unsigned long long val) { return entry.Id < val; });
+	if (it == this->Table.end() || it->Id != id) {
+		throw std::out_of_range("no set with such id in archive");
+	}
+
+	return *it;
+}
+
+int TSetArchiveReader::GetCount() const // к-во записей
+{
+	return int(this->Table.size());
+}
+
+bool TSetArchiveReader::Contains(unsigned long long id) const // есть ли запись с id
+{
+	return std::binary_search(this->Table.begin(), this->Table.end(), TSetArchiveEntry{ id, 0, 0 },
+		[](const TSetArchiveEntry& a, const TSetArchiveEntry& b) { return a.Id < b.Id; });
+}
+
+TBitField TSetArchiveReader::Load(unsigned long long id) // прочитать только эту запись
+{
+	const TSetArchiveEntry& entry = this->Find(id);
+
+	this->File.clear();
+	this->File.seekg(std::streamoff(entry.Offset));
+
+	TBitField bf(0);
+	bf.Load(this->File);
+
+	return bf;
+}
+
+TBitFieldView TSetArchiveReader::Map(unsigned long long id) // запись в отображенном файле
+{
+	const TSetArchiveEntry& entry = this->Find(id);
+
+	if (!this->pMapping) {
+		this->pMapping.reset(new TMappedFile(this->Path.c_str()));
+	}
+	if (entry.Offset + entry.Size > this->pMapping->GetSize() || entry.Size < sizeof(std::uint64_t)) {
+		throw std::runtime_error("archive entry is out of file");
+	}
+
+	const char* data = this->pMapping->GetData() + entry.Offset;
+	std::uint64_t len;
+	std::memcpy(&len, data, sizeof(len));
+	if (len > INT_MAX || sizeof(len) + (len + TELEMBits - 1) / TELEMBits * sizeof(TELEM) > entry.Size) {
+		throw std::length_error("bad archive entry length");
+	}
+
+	// запись выровнена на 8 байт, поэтому слова выровнены на TELEM
+	return TBitFieldView(reinterpret_cast<const TELEM*>(data + sizeof(len)), int(len));
+}
@@ -0,0 +1,383 @@
+// ННГУ, ВМК, Курс "Методы программирования-2", С++, ООП
+//
+// tsieve.cpp
+//
+// Сегментированное решето Эратосфена на битовых полях
+
+#include "tsieve.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+static long long _isqrt(long long n)
+{
+	long long r = (long long)std::sqrt((double)n);
+	while (r * r > n) r--;
+	while ((r + 1) * (r + 1) <= n) r++;
+
+	return r;
+}
+
+// колесо
+
+static const int WheelNoneResidues[] = { 0 };
+static const int WheelOddResidues[] = { 1 };
+static const int Wheel30Residues[] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+
+TWheel::TWheel(int modulus, const int* residues, int count)
+	: Modulus(modulus)
+	, Count(count)
+{
+	for (int j = 0; j < count; j++)
+	{
+		this->Residues[j] = residues[j];
+	}
+	for (int r = 0, j = 0; r <= modulus; r++)
+	{
+		while (j < count && residues[j] < r) j++;
+		this->Below[r] = j;
+	}
+}
+
+const TWheel& TWheel::Get(TSieveWheel wheel)
+{
+	static const TWheel none(1, WheelNoneResidues, 1);
+	static const TWheel odd(2, WheelOddResidues, 1);
+	static const TWheel mod30(30, Wheel30Residues, 8);
+
+	switch (wheel)
+	{
+	case WheelOdd: return odd;
+	case Wheel30: return mod30;
+	default: return none;
+	}
+}
+
+int TWheel::GetModulus() const // модуль колеса
+{
+	return this->Modulus;
+}
+
+int TWheel::GetCount() const // к-во битов на модуль
+{
+	return this->Count;
+}
+
+int TWheel::GetResidue(int j) const // j-й вычет
+{
+	return this->Residues[j];
+}
+
+bool TWheel::Contains(long long n) const // хранится ли число n
+{
+	if (n < 0) return false;
+
+	const int r = int(n % this->Modulus);
+	return this->Below[r + 1] != this->Below[r];
+}
+
+long long TWheel::IndexOf(long long n) const // номер бита числа n
+{
+	return n / this->Modulus * this->Count + this->Below[n % this->Modulus];
+}
+
+long long TWheel::ValueOf(long long i) const // число, хранимое в бите i
+{
+	return i / this->Count * this->Modulus + this->Residues[i % this->Count];
+}
+
+// решето
+
+TSegmentedSieve::TSegmentedSieve(long long limit, int segmentLen, TSieveWheel wheel)
+	: Limit(limit)
+	, IndexEnd(0)
+	, SegmentLen(segmentLen)
+	, Wheel(TWheel::Get(wheel))
+	, FirstCrossed(0)
+	, FirstSieved(0)
+{
+	if (limit < 0) {
+		throw std::logic_error("negative limit...");
+	}
+	if (segmentLen <= 0 || segmentLen % TELEMBits != 0) {
+		throw std::logic_error("segment length must be a positive multiple of the word size");
+	}
+
+	this->IndexEnd = this->Wheel.IndexOf(limit + 1);
+
+	// простые до sqrt(Limit) - обычным решетом; не меньше делителей модуля колеса
+	const int root = int(std::max(_isqrt(limit), 5ll));
+	TBitField s(root + 1);
+	for (int m = 2; m <= root; m++)
+	{
+		s.SetBit(m);
+	}
+	for (int m = 2; m * m <= root; m++)
+	{
+		if (s.GetBit(m)) {
+			for (int k = m * m; k <= root; k += m)
+			{
+				s.ClrBit(k);
+			}
+		}
+	}
+	for (int m = 2; m <= root; m++)
+	{
+		if (s.GetBit(m)) {
+			this->Primes.push_back(m);
+		}
+	}
+
+	while (this->FirstCrossed < int(this->Primes.size()) &&
+		this->Wheel.GetModulus() % this->Primes[this->FirstCrossed] == 0)
+	{
+		this->FirstCrossed++;
+	}
+	this->FirstSieved = this->FirstCrossed;
+	while (this->FirstSieved < int(this->Primes.size()) && this->Primes[this->FirstSieved] <= 13)
+	{
+		this->FirstSieved++;
+	}
+
+	this->BuildPattern();
+}
+
+void TSegmentedSieve::BuildPattern() // построить узор предпросеивания
+{
+	// узор периодичен с периодом period бит; хранится 32 периода, чтобы
+	// любое выровненное на слово окно начиналось с целого слова узора
+	const int modulus = this->Wheel.GetModulus(), count = this->Wheel.GetCount();
+	long long period = count;
+	for (int q : SievePatternPrimes)
+	{
+		if (modulus % q != 0) {
+			this->PatternPrimes.push_back(q);
+			period *= q;
+		}
+	}
+
+	TBitField pattern(int(period * TELEMBits));
+	TELEM* mem = pattern.GetMem();
+	std::memset(mem, 0xFF, pattern.GetMemLen() * sizeof(TELEM));
+	for (int q : this->PatternPrimes)
+	{
+		for (int j = 0; j < count; j++)
+		{
+			for (long long k = this->Wheel.IndexOf((long long)q * this->Wheel.GetResidue(j)); k < pattern.GetLength(); k += (long long)count * q)
+			{
+				mem[k / TELEMBits] &= ~(TELEM(1) << (k % TELEMBits));
+			}
+		}
+	}
+
+	this->Pattern.assign(mem, mem + pattern.GetMemLen());
+}
+
+void TSegmentedSieve::PreSieve(long long low, TBitField& window) const // заполнить окно узором
+{
+	TELEM* mem = window.GetMem();
+	const int memLen = window.GetMemLen();
+	const long long high = low + window.GetLength();
+
+	if (low % TELEMBits == 0) {
+		const long long period = (long long)this->Pattern.size();
+		long long pos = low / TELEMBits % period;
+		for (int w = 0; w < memLen;)
+		{
+			const int len = int(std::min<long long>(memLen - w, period - pos));
+			std::memcpy(mem + w, this->Pattern.data() + pos, len * sizeof(TELEM));
+			w += len;
+			pos = 0;
+		}
+	}
+	else {
+		// окно не выровнено на слово - обычное вычеркивание
+		const long long lowValue = this->Wheel.ValueOf(low);
+		const int modulus = this->Wheel.GetModulus();
+		std::memset(mem, 0xFF, memLen * sizeof(TELEM));
+		for (int q : this->PatternPrimes)
+		{
+			const long long m = (lowValue + q - 1) / q;
+			for (int j = 0; j < this->Wheel.GetCount(); j++)
+			{
+				const long long first = m + ((this->Wheel.GetResidue(j) - m) % modulus + modulus) % modulus;
+				for (long long k = this->Wheel.IndexOf(q * first); k < high; k += (long long)this->Wheel.GetCount() * q)
+				{
+					window.ClrBit(int(k - low));
+				}
+			}
+		}
+	}
+
+	if (window.GetLength() % TELEMBits != 0) {
+		mem[memLen - 1] &= TELEM(-1) >> (TELEMBits - window.GetLength() % TELEMBits);
+	}
+
+	// сами простые узора вычеркнуты вместе с кратными - вернуть их
+	for (int q : this->PatternPrimes)
+	{
+		const long long index = this->Wheel.IndexOf(q);
+		if (index >= low && index < high && q <= this->Limit) {
+			window.SetBit(int(index - low));
+		}
+	}
+}
+
+long long TSegmentedSieve::GetLimit() const // верхняя граница
+{
+	return this->Limit;
+}
+
+long long TSegmentedSieve::GetIndexEnd() const // к-во битов во всех окнах
+{
+	return this->IndexEnd;
+}
+
+int TSegmentedSieve::GetSegmentLen() const // длина окна
+{
+	return this->SegmentLen;
+}
+
+const TWheel& TSegmentedSieve::GetWheel() const // представление чисел в окнах
+{
+	return this->Wheel;
+}
+
+const std::vector<int>& TSegmentedSieve::GetBasePrimes() const // простые до sqrt(Limit)
+{
+	return this->Primes;
+}
+
+void TSegmentedSieve::InitOffsets(long long low, std::vector<long long>& next) const // первые кратные от бита low
+{
+	// кратные p*m, m = r (mod M), идут в битах с шагом Count * p
+	const long long lowValue = this->Wheel.ValueOf(low);
+	const int modulus = this->Wheel.GetModulus(), count = this->Wheel.GetCount();
+
+	next.assign(this->Primes.size() * count, 0);
+	for (std::size_t i = this->FirstSieved; i < this->Primes.size(); i++)
+	{
+		const long long p = this->Primes[i];
+		const long long start = std::max(p, (lowValue + p - 1) / p);
+		for (int j = 0; j < count; j++)
+		{
+			const long long m = start + ((this->Wheel.GetResidue(j) - start) % modulus + modulus) % modulus;
+			next[i * count + j] = this->Wheel.IndexOf(p * m);
+		}
+	}
+}
+
+void TSegmentedSieve::CrossOff(long long low, TBitField& window, std::vector<long long>& next) const // просеять окно
+{
+	TELEM* mem = window.GetMem();
+	const long long high = low + window.GetLength();
+	const long long highValue = this->Wheel.ValueOf(high);
+	const int count = this->Wheel.GetCount();
+
+	this->PreSieve(low, window);
+	for (long long i = low; i < high && this->Wheel.ValueOf(i) < 2; i++)
+	{
+		window.ClrBit(int(i - low));
+	}
+
+	for (std::size_t i = this->FirstSieved; i < this->Primes.size(); i++)
+	{
+		const long long p = this->Primes[i];
+		if (p * p >= highValue) break; // у следующих простых кратных в окне тоже нет
+
+		const long long step = count * p;
+		for (int j = 0; j < count; j++)
+		{
+			long long k = next[i * count + j];
+			for (; k < high; k += step)
+			{
+				const long long bit = k - low;
+				mem[bit / TELEMBits] &= ~(TELEM(1) << (bit % TELEMBits));
+			}
+			next[i * count + j] = k;
+		}
+	}
+}
+
+long long TSegmentedSieve::Count() const // к-во простых до Limit
+{
+	long long count = 0;
+	for (int i = 0; i < this->FirstCrossed; i++)
+	{
+		count += this->Primes[i] <= this->Limit;
+	}
+
+	this->ForEachSegment([&count](long long, const TBitField& window)
+	{
+		count += window.GetCount();
+	});
+
+	return count;
+}
+
+// параллельное просеивание
+
+long long TSegmentedSieve::GetWindowCount() const // к-во окон
+{
+	return (this->IndexEnd + this->SegmentLen - 1) / this->SegmentLen;
+}
+
+long long TSegmentedSieve::Count(int threads) const // к-во простых до Limit
+{
+	long long count = 0;
+	for (int i = 0; i < this->FirstCrossed; i++)
+	{
+		count += this->Primes[i] <= this->Limit;
+	}
+
+	std::atomic<long long> windowsCount(0);
+	this->ForEachSegment([&windowsCount](long long, const TBitField& window)
+	{
+		windowsCount += window.GetCount();
+	}, threads);
+
+	return count + windowsCount;
+}
+
+std::vector<long long> TSegmentedSieve::GetPrimes(int threads) const // все простые до Limit
+{
+	// простые каждого окна собираются отдельно и затем сливаются по порядку
+	std::vector<std::vector<long long>> parts(std::size_t(this->GetWindowCount()));
+	this->ForEachSegment([this, &parts](long long low, const TBitField& window)
+	{
+		std::vector<long long>& part = parts[std::size_t(low / this->SegmentLen)];
+		part.reserve(window.GetCount());
+
+		const TELEM* mem = window.GetMem();
+		for (int i = 0; i < window.GetMemLen(); i++)
+		{
+			for (TELEM word = mem[i]; word != 0; word &= word - 1)
+			{
+				part.push_back(this->Wheel.ValueOf(low + (long long)i * TELEMBits + _ctz(word)));
+			}
+		}
+	}, threads);
+
+	std::vector<long long> primes;
+	std::size_t total = this->FirstCrossed;
+	for (const auto& part : parts)
+	{
+		total += part.size();
+	}
+	primes.reserve(total);
+
+	for (int i = 0; i < this->FirstCrossed; i++)
+	{
+		if (this->Primes[i] <= this->Limit) {
+			primes.push_back(this->Primes[i]);
+		}
+	}
+	for (auto& part : parts)
+	{
+		primes.insert(primes.end(), part.begin(), part.end());
+		std::vector<long long>().swap(part);
+	}
+
+	return primes;
+}
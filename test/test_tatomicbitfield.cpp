@@ -0,0 +1,66 @@
+#include "tatomicbitfield.h"
+
+#include <gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST(TAtomicBitField, can_set_and_clear_bit)
+{
+  TAtomicBitField bf(100);
+
+  bf.SetBit(70);
+  EXPECT_EQ(1, bf.GetBit(70));
+  EXPECT_EQ(0, bf.GetBit(71));
+
+  bf.ClrBit(70, std::memory_order_release);
+  EXPECT_EQ(0, bf.GetBit(70, std::memory_order_acquire));
+}
+
+TEST(TAtomicBitField, throws_when_set_bit_out_of_range)
+{
+  TAtomicBitField bf(10);
+
+  ASSERT_ANY_THROW(bf.SetBit(10));
+  ASSERT_ANY_THROW(bf.TestAndSet(-1));
+}
+
+TEST(TAtomicBitField, test_and_set_returns_previous_value)
+{
+  TAtomicBitField bf(10);
+
+  EXPECT_FALSE(bf.TestAndSet(3));
+  EXPECT_TRUE(bf.TestAndSet(3));
+  EXPECT_TRUE(bf.TestAndClear(3));
+  EXPECT_FALSE(bf.TestAndClear(3));
+}
+
+TEST(TAtomicBitField, memory_is_cache_line_aligned)
+{
+  TAtomicBitField bf(5);
+
+  EXPECT_EQ(CacheLineSize / int(sizeof(TELEM)), bf.GetMemLen());
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(bf.GetMem()) % CacheLineSize);
+}
+
+TEST(TAtomicBitField, concurrent_writes_to_one_word_are_not_lost)
+{
+  const int size = 4096, threads = 4;
+  TAtomicBitField bf(size);
+  std::atomic<int> winners(0);
+
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++)
+    pool.emplace_back([&]()
+    {
+      for (int i = 0; i < size; i++)
+        if (!bf.TestAndSet(i, std::memory_order_relaxed))
+          winners++;
+    });
+  for (auto &th : pool)
+    th.join();
+
+  EXPECT_EQ(size, winners.load());
+  EXPECT_EQ(size, bf.ToBitField().GetCount());
+}
@@ -328,3 +328,68 @@ TEST(awful_bitfield, can_enter_output)
 
     ASSERT_TRUE(b == b1);
 }
+
+TEST(TBitField, copies_share_memory_until_modified)
+{
+  TBitField bf(100);
+  bf.SetBit(7);
+  const TBitField copy(bf);
+
+  EXPECT_EQ(static_cast<const TBitField&>(bf).GetMem(), copy.GetMem());
+
+  bf.SetBit(8);
+  EXPECT_NE(static_cast<const TBitField&>(bf).GetMem(), copy.GetMem());
+  EXPECT_EQ(1, copy.GetBit(7));
+  EXPECT_EQ(0, copy.GetBit(8));
+}
+
+TEST(TBitField, writing_through_mem_does_not_change_copy)
+{
+  TBitField bf(64), copy(1);
+  copy = bf;
+
+  bf.GetMem()[0] = 5;
+
+  EXPECT_EQ(0, copy.GetBit(0));
+  EXPECT_EQ(1, bf.GetBit(0));
+}
+
+TEST(TBitField, copies_can_be_modified_independently)
+{
+  TBitField bf(40);
+  TBitField a(bf), b(bf);
+
+  a.SetBit(1);
+  b.SetBit(2);
+  bf.ClrBit(0);
+
+  EXPECT_EQ(0, a.GetBit(2));
+  EXPECT_EQ(0, b.GetBit(1));
+  EXPECT_EQ(0, bf.GetCount());
+}
+
+TEST(TBitField, modified_copy_keeps_resource)
+{
+  std::pmr::monotonic_buffer_resource arena;
+  TBitField bf(40, &arena);
+  TBitField copy(bf);
+
+  copy.SetBit(3);
+
+  EXPECT_EQ(&arena, copy.GetResource());
+  EXPECT_EQ(0, bf.GetBit(3));
+}
+
+TEST(TBitField, memory_is_aligned_and_padded_with_zeros)
+{
+  TBitField bf(100);
+  TBitField neg = ~bf;
+  const TELEM *mem = neg.GetMem();
+
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(mem) % BitFieldAlign);
+  EXPECT_EQ(0, neg.GetPaddedMemLen() * int(sizeof(TELEM)) % BitFieldAlign);
+  EXPECT_LE(neg.GetMemLen(), neg.GetPaddedMemLen());
+  for (int i = neg.GetMemLen(); i < neg.GetPaddedMemLen(); i++)
+    EXPECT_EQ(0u, mem[i]);
+  EXPECT_EQ(100, neg.GetCount());
+}
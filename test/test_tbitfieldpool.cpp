@@ -0,0 +1,70 @@
+#include "tbitfieldpool.h"
+#include "tset.h"
+
+#include <gtest.h>
+#include <memory>
+#include <thread>
+
+TEST(TBitFieldPool, set_algebra_reuses_buffers)
+{
+  TBitFieldPool &pool = TBitFieldPool::Get();
+  TSet a(1000, &pool), b(1000, &pool);
+  a.InsElem(1);
+  b.InsElem(2);
+
+  {
+    TSet warm = (a + b) * ~a; // разогрев
+  }
+  const long long misses = TBitFieldPool::GetMissCount();
+
+  for (int i = 0; i < 100; i++)
+  {
+    TSet c = (a + b) * ~a;
+    EXPECT_EQ(1, c.IsMember(2));
+    EXPECT_EQ(0, c.IsMember(1));
+  }
+
+  EXPECT_EQ(misses, TBitFieldPool::GetMissCount());
+  EXPECT_LT(0, TBitFieldPool::GetHitCount());
+}
+
+TEST(TBitFieldPool, reused_buffer_is_zeroed)
+{
+  TBitFieldPool &pool = TBitFieldPool::Get();
+  {
+    TBitField bf(300, &pool);
+    for (int i = 0; i < 300; i++)
+      bf.SetBit(i);
+  }
+
+  TBitField bf(300, &pool);
+  EXPECT_EQ(0, bf.GetCount());
+}
+
+TEST(TBitFieldPool, buffer_can_be_freed_in_other_thread)
+{
+  TBitFieldPool &pool = TBitFieldPool::Get();
+  TBitField *bf = new TBitField(5000, &pool);
+  bf->SetBit(4999);
+
+  std::thread([bf]() { delete bf; }).join();
+
+  TBitField other(5000, &pool);
+  EXPECT_EQ(0, other.GetCount());
+}
+
+TEST(TBitFieldPool, field_can_outlive_thread_pool)
+{
+  TBitFieldPool &pool = TBitFieldPool::Get();
+
+  // late создан до пула потока и уничтожается после него
+  std::thread([&pool]()
+  {
+    thread_local std::unique_ptr<TBitField> late;
+    late.reset(new TBitField(5000, &pool));
+    late->SetBit(1);
+  }).join();
+
+  TBitField bf(5000, &pool);
+  EXPECT_EQ(0, bf.GetCount());
+}
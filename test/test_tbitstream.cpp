@@ -0,0 +1,127 @@
+#include "tbitstream.h"
+
+#include <gtest.h>
+#include <sstream>
+
+static std::string save_to_string(const TBitField &bf)
+{
+  std::ostringstream ostr;
+  bf.Save(ostr);
+  return ostr.str();
+}
+
+TEST(TBitField, can_save_and_load_binary)
+{
+  TBitField bf(70), res(3);
+  bf.SetBit(0);
+  bf.SetBit(33);
+  bf.SetBit(69);
+
+  std::istringstream istr(save_to_string(bf));
+  res.Load(istr);
+
+  EXPECT_EQ(bf, res);
+}
+
+TEST(TBitField, throws_when_load_truncated_binary)
+{
+  TBitField bf(70), res(3);
+  std::string data = save_to_string(bf);
+  data.resize(data.size() - 1);
+
+  std::istringstream istr(data);
+  ASSERT_ANY_THROW(res.Load(istr));
+}
+
+TEST(TBitStreamReader, reads_stream_by_chunks)
+{
+  const int size = 200;
+  TBitField bf(size);
+  for (int i = 0; i < size; i += 7)
+    bf.SetBit(i);
+
+  std::istringstream istr(save_to_string(bf));
+  TBitStreamReader reader(istr, 64);
+
+  int chunks = 0;
+  while (reader.Next())
+  {
+    const TBitField &chunk = reader.GetChunk();
+    for (int i = 0; i < chunk.GetLength(); i++)
+      EXPECT_EQ(bf.GetBit(int(reader.GetChunkPos()) + i), chunk.GetBit(i));
+    chunks++;
+  }
+
+  EXPECT_EQ(4, chunks);
+  EXPECT_EQ(size, (int)reader.GetLength());
+}
+
+TEST(TBitStreamReader, throws_when_chunk_length_is_not_word_multiple)
+{
+  TBitField bf(10);
+  std::istringstream istr(save_to_string(bf));
+
+  ASSERT_ANY_THROW(TBitStreamReader reader(istr, 33));
+}
+
+TEST(TBitStreamWriter, written_stream_can_be_loaded)
+{
+  const int size = 100;
+  std::ostringstream ostr;
+  TBitStreamWriter writer(ostr, size, 32);
+  while (!writer.IsFull())
+  {
+    TBitField &chunk = writer.GetChunk();
+    chunk.SetBit(chunk.GetLength() - 1);
+    writer.Commit();
+  }
+  writer.Close();
+
+  TBitField res(1), expBf(size);
+  expBf.SetBit(31);
+  expBf.SetBit(63);
+  expBf.SetBit(95);
+  expBf.SetBit(99);
+  std::istringstream istr(ostr.str());
+  res.Load(istr);
+
+  EXPECT_EQ(expBf, res);
+}
+
+TEST(TBitStreamWriter, throws_when_close_incomplete_stream)
+{
+  std::ostringstream ostr;
+  TBitStreamWriter writer(ostr, 100, 32);
+  writer.Commit();
+
+  ASSERT_ANY_THROW(writer.Close());
+}
+
+TEST(BitStream, or_and_of_streams_match_bitfield_operations)
+{
+  const int size1 = 150, size2 = 230;
+  TBitField bf1(size1), bf2(size2);
+  for (int i = 0; i < size1; i += 3)
+    bf1.SetBit(i);
+  for (int i = 0; i < size2; i += 5)
+    bf2.SetBit(i);
+  const std::string data1 = save_to_string(bf1), data2 = save_to_string(bf2);
+
+  std::istringstream in1(data1), in2(data2);
+  TBitStreamReader a(in1, 64), b(in2, 64);
+  std::ostringstream orStr;
+  BitStreamOr(a, b, orStr);
+
+  std::istringstream in3(data1), in4(data2);
+  TBitStreamReader c(in3, 64), d(in4, 64);
+  std::ostringstream andStr;
+  BitStreamAnd(c, d, andStr);
+
+  TBitField orRes(1), andRes(1);
+  std::istringstream orIn(orStr.str()), andIn(andStr.str());
+  orRes.Load(orIn);
+  andRes.Load(andIn);
+
+  EXPECT_EQ(TBitField(bf1) | bf2, orRes);
+  EXPECT_EQ(TBitField(bf1) & bf2, andRes);
+}
@@ -0,0 +1,114 @@
+#include "tblockmap.h"
+
+#include <gtest.h>
+#include <random>
+#include <vector>
+
+// поиск перебором для сравнения
+static int find_run_slow(const TBlockMap &m, int len, TBlockFit fit)
+{
+  int start = -1, best = 0;
+  for (int i = 0; i < m.GetLength(); )
+  {
+    if (!m.IsFree(i)) { i++; continue; }
+    int j = i;
+    while (j < m.GetLength() && m.IsFree(j)) j++;
+    if (j - i >= len && (start < 0 || (fit == FitBest && j - i < best)))
+    {
+      start = i;
+      best = j - i;
+    }
+    i = j;
+  }
+  return start;
+}
+
+TEST(TBlockMap, new_map_is_free)
+{
+  TBlockMap m(100);
+
+  EXPECT_EQ(100, m.GetFreeCount());
+  EXPECT_EQ(0, m.FindZeroRun(100));
+  EXPECT_EQ(-1, m.FindZeroRun(101));
+}
+
+TEST(TBlockMap, allocate_takes_first_fit)
+{
+  TBlockMap m(200);
+  m.AllocateRange(10, 5);
+
+  EXPECT_EQ(0, m.Allocate(10));
+  EXPECT_EQ(15, m.Allocate(1));
+  EXPECT_EQ(200 - 16, m.GetFreeCount());
+}
+
+TEST(TBlockMap, best_fit_takes_smallest_run)
+{
+  TBlockMap m(300);
+  m.AllocateRange(0, 10);
+  m.AllocateRange(50, 10);  // свободно [10, 50) - 40 блоков
+  m.AllocateRange(70, 100); // свободно [60, 70) - 10 блоков, [170, 300)
+
+  EXPECT_EQ(10, m.FindZeroRun(8, FitFirst));
+  EXPECT_EQ(60, m.FindZeroRun(8, FitBest));
+  EXPECT_EQ(10, m.FindZeroRun(40, FitBest));
+  EXPECT_EQ(170, m.FindZeroRun(41, FitBest));
+}
+
+TEST(TBlockMap, finds_runs_crossing_words_and_groups)
+{
+  const int size = 3 * BlockGroupMemLen * 32;
+  TBlockMap m(size);
+  m.AllocateRange(0, BlockGroupMemLen * 32 - 5);
+  m.AllocateRange(BlockGroupMemLen * 32 + 100, size - BlockGroupMemLen * 32 - 100);
+
+  EXPECT_EQ(BlockGroupMemLen * 32 - 5, m.FindZeroRun(105));
+  EXPECT_EQ(-1, m.FindZeroRun(106));
+}
+
+TEST(TBlockMap, free_range_makes_blocks_available)
+{
+  TBlockMap m(64);
+  ASSERT_EQ(0, m.Allocate(64));
+
+  m.FreeRange(20, 30);
+
+  EXPECT_EQ(20, m.FindZeroRun(30));
+  EXPECT_EQ(30, m.GetFreeCount());
+}
+
+TEST(TBlockMap, throws_on_wrong_ranges)
+{
+  TBlockMap m(64);
+  m.AllocateRange(10, 10);
+
+  ASSERT_ANY_THROW(m.AllocateRange(15, 10));
+  ASSERT_ANY_THROW(m.FreeRange(5, 10));
+  ASSERT_ANY_THROW(m.AllocateRange(60, 10));
+  ASSERT_ANY_THROW(m.FindZeroRun(0));
+}
+
+TEST(TBlockMap, search_matches_bit_by_bit_search)
+{
+  const int size = 5 * BlockGroupMemLen * 32 + 13;
+  TBlockMap m(size);
+  std::mt19937 gen(7);
+  std::vector<std::pair<int, int>> taken;
+
+  for (int step = 0; step < 3000; step++)
+  {
+    const int len = int(gen() % 200) + 1;
+    const TBlockFit fit = step % 2 ? FitBest : FitFirst;
+    ASSERT_EQ(find_run_slow(m, len, fit), m.FindZeroRun(len, fit));
+
+    if (taken.empty() || gen() % 3) {
+      const int start = m.Allocate(len, fit);
+      if (start >= 0) taken.push_back({ start, len });
+    }
+    else {
+      const int k = int(gen() % taken.size());
+      m.FreeRange(taken[k].first, taken[k].second);
+      taken.erase(taken.begin() + k);
+    }
+  }
+}
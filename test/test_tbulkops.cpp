@@ -0,0 +1,96 @@
+#include "tbulkops.h"
+
+#include <gtest.h>
+
+static TBitField make_bitfield(int size, int step, int shift)
+{
+  TBitField bf(size);
+  for (int i = shift; i < size; i += step)
+    bf.SetBit(i);
+  return bf;
+}
+
+TEST(ParallelBitField, operations_match_operators_on_large_fields)
+{
+  const int size = 64 * ParallelMinMemLen + 17;
+  TBitField a = make_bitfield(size, 3, 0), b = make_bitfield(size, 5, 1);
+
+  EXPECT_EQ(TBitField(a) | b, Union(a, b, 4));
+  EXPECT_EQ(TBitField(a) & b, Intersection(a, b, 4));
+  EXPECT_EQ(~TBitField(a), Complement(a, 4));
+  EXPECT_EQ(a.GetCount(), PopCount(a, 4));
+  EXPECT_TRUE(IsEqual(a, TBitField(a), 4));
+  EXPECT_FALSE(IsEqual(a, b, 4));
+}
+
+TEST(ParallelBitField, operations_on_fields_of_non_equal_size)
+{
+  TBitField a = make_bitfield(40, 2, 0), b = make_bitfield(100, 7, 0);
+
+  EXPECT_EQ(TBitField(a) | b, Union(a, b, 2));
+  EXPECT_EQ(TBitField(a) & b, Intersection(b, a, 2));
+  EXPECT_FALSE(IsEqual(a, b, 2));
+}
+
+TEST(ParallelBitField, accepts_execution_policy)
+{
+  const int size = 64 * ParallelMinMemLen;
+  TBitField a = make_bitfield(size, 3, 0), b = make_bitfield(size, 4, 0);
+
+  EXPECT_EQ(Union(a, b, 1), Union(std::execution::par, a, b));
+  EXPECT_EQ(Intersection(a, b, 1), Intersection(std::execution::seq, a, b));
+  EXPECT_EQ(Complement(a, 1), Complement(std::execution::par_unseq, a));
+  EXPECT_EQ(PopCount(a, 1), PopCount(std::execution::par, a));
+  EXPECT_TRUE(IsEqual(std::execution::par, a, TBitField(a)));
+}
+
+TEST(ParallelSet, operations_match_operators)
+{
+  const int size = 40 * ParallelMinMemLen;
+  TSet a(make_bitfield(size, 6, 0)), b(make_bitfield(size, 10, 0));
+
+  EXPECT_EQ(TSet(a) + b, Union(std::execution::par, a, b));
+  EXPECT_EQ(TSet(a) * b, Intersection(a, b, 3));
+  EXPECT_EQ(~TSet(a), Complement(a, 3));
+  EXPECT_EQ(size / 6 + 1, PopCount(a, 3));
+  EXPECT_TRUE(IsEqual(a, TSet(a), 3));
+}
+
+TEST(ParallelReduce, union_of_many_sets_matches_operator)
+{
+  std::vector<TSet> sets;
+  for (int i = 0; i < 100; i++)
+  {
+    TSet s(1000);
+    s.InsElem(i * 7 % 1000);
+    s.InsElem(i * 13 % 1000);
+    sets.push_back(s);
+  }
+  TSet expected(1000);
+  for (const TSet &s : sets)
+    expected = expected + s;
+
+  EXPECT_EQ(expected, Reduce(sets.data(), (long long)sets.size(), ReduceUnion, 1));
+  EXPECT_EQ(expected, Reduce(sets.data(), (long long)sets.size(), ReduceUnion, 3));
+  EXPECT_EQ(expected, Reduce(sets.begin(), sets.end(), ReduceUnion, 8));
+}
+
+TEST(ParallelReduce, intersection_of_fields_with_different_length)
+{
+  std::vector<TBitField> fields;
+  for (int i = 0; i < 9; i++)
+    fields.push_back(make_bitfield(100 + 10 * i, 2, 0));
+  TBitField expected = fields[0];
+  for (const TBitField &bf : fields)
+    expected = expected & bf;
+
+  EXPECT_EQ(expected, Reduce(fields.data(), (long long)fields.size(), ReduceIntersection, 4));
+  EXPECT_EQ(180, Reduce(fields.begin(), fields.end(), ReduceIntersection).GetLength());
+}
+
+TEST(ParallelReduce, throws_on_empty_range)
+{
+  std::vector<TSet> sets;
+
+  ASSERT_ANY_THROW(Reduce(sets.begin(), sets.end(), ReduceUnion));
+}
@@ -0,0 +1,117 @@
+#include "tconcurrentset.h"
+
+#include <gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(TConcurrentSet, can_create_from_set)
+{
+  TSet s(100);
+  s.InsElem(3);
+  s.InsElem(99);
+  TConcurrentSet cs(s);
+
+  TConcurrentSet::TSnapshot snap = cs.Snapshot();
+  EXPECT_EQ(100, snap.GetMaxPower());
+  EXPECT_EQ(s, snap.ToSet());
+}
+
+TEST(TConcurrentSet, changes_are_visible_only_after_publish)
+{
+  TConcurrentSet cs(3 * ConcurrentChunkLen);
+  cs.InsElem(5);
+
+  EXPECT_FALSE(cs.Snapshot().IsMember(5));
+  cs.Publish();
+  EXPECT_TRUE(cs.Snapshot().IsMember(5));
+}
+
+TEST(TConcurrentSet, snapshot_is_not_changed_by_later_versions)
+{
+  const int size = 3 * ConcurrentChunkLen;
+  TConcurrentSet cs(size);
+  cs.InsElem(1);
+  cs.Publish();
+
+  TConcurrentSet::TSnapshot old = cs.Snapshot();
+  cs.DelElem(1);
+  cs.InsElem(size - 1);
+  cs.Publish();
+  cs.InsElem(ConcurrentChunkLen);
+  cs.Publish();
+
+  EXPECT_TRUE(old.IsMember(1));
+  EXPECT_FALSE(old.IsMember(size - 1));
+  EXPECT_FALSE(old.IsMember(ConcurrentChunkLen));
+
+  TConcurrentSet::TSnapshot now = cs.Snapshot();
+  EXPECT_FALSE(now.IsMember(1));
+  EXPECT_TRUE(now.IsMember(size - 1));
+  EXPECT_TRUE(now.IsMember(ConcurrentChunkLen));
+}
+
+TEST(TConcurrentSet, retired_versions_are_kept_while_snapshot_is_alive)
+{
+  TConcurrentSet cs(100);
+  {
+    TConcurrentSet::TSnapshot snap = cs.Snapshot();
+    cs.InsElem(1);
+    cs.Publish();
+    EXPECT_EQ(1, cs.Reclaim());
+  }
+  EXPECT_EQ(0, cs.Reclaim());
+}
+
+TEST(TConcurrentSet, throws_when_elem_is_out_of_range)
+{
+  TConcurrentSet cs(10);
+
+  ASSERT_ANY_THROW(cs.InsElem(10));
+  ASSERT_ANY_THROW(cs.DelElem(-1));
+  ASSERT_ANY_THROW(cs.Snapshot().IsMember(10));
+}
+
+TEST(TConcurrentSet, readers_see_consistent_versions_during_updates)
+{
+  // писатель меняет пары элементов из разных участков в одной версии
+  const int size = 4 * ConcurrentChunkLen;
+  TConcurrentSet cs(size);
+  std::atomic<bool> done(false);
+  std::atomic<int> broken(0);
+
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++)
+  {
+    readers.emplace_back([&, t]
+    {
+      unsigned i = t;
+      while (!done.load())
+      {
+        TConcurrentSet::TSnapshot snap = cs.Snapshot();
+        const int a = int(i * 7919u % (size / 2));
+        if (snap.IsMember(a) != snap.IsMember(size - 1 - a)) broken++;
+        i++;
+      }
+    });
+  }
+
+  for (int k = 0; k < 2000; k++)
+  {
+    const int a = (k * 7919) % (size / 2);
+    if (k % 3 == 0) {
+      cs.DelElem(a);
+      cs.DelElem(size - 1 - a);
+    }
+    else {
+      cs.InsElem(a);
+      cs.InsElem(size - 1 - a);
+    }
+    cs.Publish();
+  }
+  done = true;
+  for (std::thread& r : readers)
+    r.join();
+
+  EXPECT_EQ(0, broken.load());
+  EXPECT_EQ(0, cs.Reclaim());
+}
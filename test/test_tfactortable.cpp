@@ -0,0 +1,59 @@
+#include "tfactortable.h"
+
+#include <gtest.h>
+
+static std::vector<std::uint32_t> naive_factors(std::uint32_t n)
+{
+  std::vector<std::uint32_t> factors;
+  for (std::uint32_t d = 2; d * d <= n; d++)
+    for (; n % d == 0; n /= d)
+      factors.push_back(d);
+  if (n > 1)
+    factors.push_back(n);
+  return factors;
+}
+
+TEST(TFactorTable, smallest_factors_match_naive_search)
+{
+  const std::uint32_t n = 20000;
+  TFactorTable table(n);
+
+  for (std::uint32_t m = 2; m <= n; m++)
+    EXPECT_EQ(naive_factors(m)[0], table.SmallestFactor(m));
+}
+
+TEST(TFactorTable, can_check_primality)
+{
+  TFactorTable table(100);
+
+  EXPECT_FALSE(table.IsPrime(0));
+  EXPECT_FALSE(table.IsPrime(1));
+  EXPECT_TRUE(table.IsPrime(2));
+  EXPECT_TRUE(table.IsPrime(97));
+  EXPECT_FALSE(table.IsPrime(91));
+  ASSERT_ANY_THROW(table.IsPrime(101));
+}
+
+TEST(TFactorTable, can_factorize_batch)
+{
+  TFactorTable table(1000000);
+  const std::uint32_t values[] = { 1, 2, 360, 999983, 1000000, 994009 };
+  TFactorization res;
+
+  table.Factorize(values, 6, res);
+
+  ASSERT_EQ(6u, res.GetCount());
+  for (std::size_t i = 0; i < res.GetCount(); i++)
+  {
+    std::vector<std::uint32_t> factors(res.GetFactors(i), res.GetFactors(i) + res.GetFactorCount(i));
+    EXPECT_EQ(naive_factors(values[i]), factors);
+  }
+}
+
+TEST(TFactorTable, throws_when_factorize_number_out_of_table)
+{
+  TFactorTable table(100);
+  std::vector<std::uint32_t> factors;
+
+  ASSERT_ANY_THROW(table.Factorize(101, factors));
+}
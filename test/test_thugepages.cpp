@@ -0,0 +1,50 @@
+#include "thugepages.h"
+#include "tbitfield.h"
+
+#include <gtest.h>
+#include <cstdint>
+
+TEST(THugePageResource, small_fields_use_upstream)
+{
+  THugePageResource huge;
+  {
+    TBitField bf(1000, &huge);
+    bf.SetBit(999);
+  }
+
+  const THugePageStats stats = huge.GetStats();
+  EXPECT_EQ(0, stats.MappedCount);
+  EXPECT_EQ(1, stats.UpstreamCount);
+}
+
+TEST(THugePageResource, large_field_is_mapped_on_huge_page_boundary)
+{
+  THugePageResource huge;
+  const int size = 8 * int(HugePageSize) * 2;
+  TBitField bf(size, &huge);
+
+  bf.SetBit(0);
+  bf.SetBit(size - 1);
+
+  const THugePageStats stats = huge.GetStats();
+  EXPECT_EQ(1, stats.MappedCount);
+  EXPECT_EQ(3 * (long long)HugePageSize, stats.MappedBytes);
+  EXPECT_LE(stats.HugeBytes, stats.MappedBytes);
+  // заголовок поля занимает одну строку кэша в начале участка
+  EXPECT_EQ(BitFieldAlign, int(reinterpret_cast<std::uintptr_t>(bf.GetMem()) % HugePageSize));
+  EXPECT_EQ(2, bf.GetCount());
+}
+
+TEST(THugePageResource, hugetlb_mode_gives_usable_memory)
+{
+  THugePageResource huge(HugePageSize, true);
+  {
+    TBitField bf(8 * int(HugePageSize), &huge);
+    bf.SetBit(12345);
+    EXPECT_EQ(1, bf.GetBit(12345));
+  }
+
+  const THugePageStats stats = huge.GetStats();
+  EXPECT_EQ(1, stats.MappedCount);
+  EXPECT_EQ(0, stats.HugeBytes);
+}
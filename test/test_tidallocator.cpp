@@ -0,0 +1,105 @@
+#include "tidallocator.h"
+#include "tbitops.h"
+
+#include <gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(TIdAllocator, gives_out_all_ids_once)
+{
+  const int size = 100;
+  TIdAllocator ids(size);
+  TBitField seen(size);
+
+  for (int i = 0; i < size; i++)
+  {
+    const int id = ids.Acquire();
+    ASSERT_TRUE(id >= 0 && id < size);
+    EXPECT_EQ(0, seen.GetBit(id));
+    seen.SetBit(id);
+  }
+
+  EXPECT_EQ(-1, ids.Acquire());
+}
+
+TEST(TIdAllocator, released_id_can_be_acquired_again)
+{
+  TIdAllocator ids(40);
+  int all[40];
+  ASSERT_EQ(40, ids.AcquireN(40, all));
+
+  ids.Release(17);
+
+  EXPECT_EQ(0, ids.IsAcquired(17));
+  EXPECT_EQ(17, ids.Acquire());
+  EXPECT_EQ(1, ids.IsAcquired(17));
+}
+
+TEST(TIdAllocator, acquire_n_returns_available_count)
+{
+  TIdAllocator ids(70);
+  std::vector<int> got(100);
+
+  EXPECT_EQ(50, ids.AcquireN(50, got.data()));
+  EXPECT_EQ(20, ids.AcquireN(50, got.data() + 50));
+  EXPECT_EQ(0, ids.AcquireN(1, got.data()));
+}
+
+TEST(TIdAllocator, keeps_search_hint_per_allocator)
+{
+  const int size = 10 * TELEMBits;
+  TIdAllocator a(size), b(size);
+  std::vector<int> all(size);
+
+  // в b свободен только эл-т 5
+  ASSERT_EQ(size, b.AcquireN(size, all.data()));
+  for (int id = 5 * TELEMBits; id < 6 * TELEMBits; id++)
+    b.Release(id);
+
+  const int first = a.Acquire();
+  for (int i = 0; i < 20; i++)
+  {
+    EXPECT_EQ(5, b.Acquire() / TELEMBits);
+    EXPECT_EQ(first / TELEMBits, a.Acquire() / TELEMBits);
+  }
+}
+
+TEST(TIdAllocator, throws_when_releasing_free_id)
+{
+  TIdAllocator ids(10);
+
+  ASSERT_ANY_THROW(ids.Release(3));
+  ASSERT_ANY_THROW(ids.Release(10));
+}
+
+TEST(TIdAllocator, concurrent_acquire_and_release_do_not_share_ids)
+{
+  const int size = 1024, threads = 8, rounds = 20000;
+  TIdAllocator ids(size);
+  TAtomicBitField owned(size);
+  std::atomic<int> conflicts(0);
+
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++)
+    pool.emplace_back([&]()
+    {
+      int mine[4];
+      for (int r = 0; r < rounds; r++)
+      {
+        const int n = ids.AcquireN(r % 4 + 1, mine);
+        for (int i = 0; i < n; i++)
+          if (owned.TestAndSet(mine[i]))
+            conflicts++;
+        for (int i = 0; i < n; i++)
+        {
+          owned.ClrBit(mine[i]);
+          ids.Release(mine[i]);
+        }
+      }
+    });
+  for (auto &th : pool)
+    th.join();
+
+  EXPECT_EQ(0, conflicts.load());
+  EXPECT_EQ(size, ids.AcquireN(size, std::vector<int>(size).data()));
+}
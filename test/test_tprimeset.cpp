@@ -0,0 +1,123 @@
+#include "tprimeset.h"
+
+#include <gtest.h>
+#include <cstdio>
+#include <fstream>
+
+static bool naive_is_prime(long long n)
+{
+  if (n < 2)
+    return false;
+  for (long long d = 2; d * d <= n; d++)
+    if (n % d == 0)
+      return false;
+  return true;
+}
+
+TEST(TPrimeSet, is_prime_matches_naive_check)
+{
+  TPrimeSet primes(1000);
+
+  for (long long n = -5; n < 3000; n++)
+    EXPECT_EQ(naive_is_prime(n), primes.IsPrime(n));
+}
+
+TEST(TPrimeSet, extends_limit_lazily)
+{
+  TPrimeSet primes(100);
+  const long long limit = primes.GetLimit();
+
+  EXPECT_TRUE(primes.IsPrime(1000003));
+  EXPECT_GT(primes.GetLimit(), limit);
+  EXPECT_GE(primes.GetLimit(), 1000003);
+}
+
+TEST(TPrimeSet, can_count_primes)
+{
+  TPrimeSet primes;
+
+  EXPECT_EQ(0, primes.PrimePi(1));
+  EXPECT_EQ(1, primes.PrimePi(2));
+  EXPECT_EQ(2, primes.PrimePi(4));
+  EXPECT_EQ(25, primes.PrimePi(100));
+  EXPECT_EQ(168, primes.PrimePi(1000));
+  EXPECT_EQ(78498, primes.PrimePi(1000000));
+  EXPECT_EQ(664579, primes.PrimePi(10000000));
+}
+
+TEST(TPrimeSet, can_get_nth_prime)
+{
+  TPrimeSet primes;
+
+  EXPECT_EQ(2, primes.NthPrime(1));
+  EXPECT_EQ(3, primes.NthPrime(2));
+  EXPECT_EQ(29, primes.NthPrime(10));
+  EXPECT_EQ(104729, primes.NthPrime(10000));
+  ASSERT_ANY_THROW(primes.NthPrime(0));
+}
+
+TEST(TPrimeSet, can_get_next_and_previous_prime)
+{
+  TPrimeSet primes(10);
+
+  EXPECT_EQ(2, primes.NextPrime(0));
+  EXPECT_EQ(3, primes.NextPrime(2));
+  EXPECT_EQ(11, primes.NextPrime(7));
+  EXPECT_EQ(1009, primes.NextPrime(1000));
+  EXPECT_EQ(2, primes.PrevPrime(3));
+  EXPECT_EQ(5, primes.PrevPrime(7));
+  EXPECT_EQ(7, primes.PrevPrime(8));
+  EXPECT_EQ(997, primes.PrevPrime(1000));
+  ASSERT_ANY_THROW(primes.PrevPrime(2));
+}
+
+TEST(TPrimeSet, can_iterate_primes_in_range)
+{
+  TPrimeSet primes;
+  std::vector<long long> exp;
+  for (long long n = 90; n <= 200; n++)
+    if (naive_is_prime(n))
+      exp.push_back(n);
+
+  EXPECT_EQ(exp, primes.GetPrimes(90, 200));
+  EXPECT_EQ(std::vector<long long>({ 2, 3, 5, 7 }), primes.GetPrimes(0, 10));
+}
+
+TEST(TPrimeSet, can_save_and_open_mapped)
+{
+  const char *path = "test_tprimeset.bin";
+  TPrimeSet primes(100000);
+  primes.Save(path);
+
+  TPrimeSet mapped;
+  mapped.Open(path);
+
+  EXPECT_TRUE(mapped.IsMapped());
+  EXPECT_EQ(primes.GetLimit(), mapped.GetLimit());
+  EXPECT_EQ(9592, mapped.PrimePi(100000));
+  EXPECT_EQ(99991, mapped.PrevPrime(100000));
+  EXPECT_EQ(104729, mapped.NthPrime(10000));
+
+  EXPECT_TRUE(mapped.IsPrime(10000019));
+  EXPECT_FALSE(mapped.IsMapped());
+  EXPECT_EQ(664579, mapped.PrimePi(10000000));
+
+  std::remove(path);
+}
+
+TEST(TPrimeSet, throws_when_open_corrupted_file)
+{
+  const char *path = "test_tprimeset.bin";
+  TPrimeSet(1000).Save(path);
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(70);
+    file.put(char(0x5A));
+  }
+
+  TPrimeSet mapped;
+  ASSERT_ANY_THROW(mapped.Open(path));
+  EXPECT_EQ(25, mapped.PrimePi(100));
+
+  std::remove(path);
+}
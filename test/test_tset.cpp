@@ -1,6 +1,7 @@
 #include "tset.h"
 
 #include <gtest.h>
+#include <sstream>
 
 TEST(TSet, can_get_max_power_set)
 {
@@ -308,3 +309,101 @@ TEST(awful_set, conjunction_with_negation_is_empty_set)
 
 	ASSERT_TRUE((s * ~s) == copy_s);
 }
+
+TEST(TSet, can_save_and_load_sparse_set)
+{
+  const int size = 100000;
+  TSet set(size), res(5);
+  for (int i = 3; i < size; i += 997)
+    set.InsElem(i);
+  set.InsElem(size - 1);
+
+  std::stringstream sstr;
+  set.Save(sstr);
+  res.Load(sstr);
+
+  EXPECT_LT(sstr.str().size(), size_t(size / 8));
+  EXPECT_EQ(set, res);
+}
+
+TEST(TSet, can_save_and_load_dense_set)
+{
+  const int size = 1000;
+  TSet set(size), res(5);
+  for (int i = 0; i < size; i += 2)
+    set.InsElem(i);
+
+  std::stringstream sstr;
+  set.Save(sstr);
+  res.Load(sstr);
+
+  EXPECT_EQ(set, res);
+}
+
+TEST(TSet, can_save_and_load_empty_set)
+{
+  TSet set(70), res(5);
+
+  std::stringstream sstr;
+  set.Save(sstr);
+  res.Load(sstr);
+
+  EXPECT_EQ(set, res);
+}
+
+#include <memory_resource>
+
+// ресурс, считающий выделения
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+  int allocs = 0, frees = 0;
+private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override
+  {
+    allocs++;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void *p, std::size_t bytes, std::size_t align) override
+  {
+    frees++;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+TEST(TSet, operations_allocate_from_set_resource)
+{
+  counting_resource res;
+  {
+    TSet a(100, &res), b(100, &res);
+    a.InsElem(1);
+    b.InsElem(2);
+
+    TSet c = a + b;
+    TSet d = ~(a * b);
+
+    EXPECT_EQ(&res, c.GetResource());
+    EXPECT_EQ(&res, d.GetResource());
+    EXPECT_EQ(1, c.IsMember(1));
+    EXPECT_EQ(1, c.IsMember(2));
+  }
+  EXPECT_LT(0, res.allocs);
+  EXPECT_EQ(res.allocs, res.frees);
+}
+
+TEST(TSet, can_copy_set_into_other_resource)
+{
+  std::pmr::monotonic_buffer_resource arena;
+  TSet s(50);
+  s.InsElem(7);
+
+  TSet copy(s, &arena);
+
+  EXPECT_EQ(&arena, copy.GetResource());
+  EXPECT_EQ(s, copy);
+  EXPECT_EQ(std::pmr::get_default_resource(), s.GetResource());
+}
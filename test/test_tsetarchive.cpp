@@ -0,0 +1,99 @@
+#include "tsetarchive.h"
+#include "tset.h"
+
+#include <gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+static const char *ArchivePath = "test_tsetarchive.bin";
+
+static TBitField make_bitfield(int size, int step)
+{
+  TBitField bf(size);
+  for (int i = 0; i < size; i += step)
+    bf.SetBit(i);
+  return bf;
+}
+
+TEST(TSetArchive, can_load_entries_by_id)
+{
+  {
+    TSetArchiveWriter writer(ArchivePath);
+    for (int id = 20; id > 0; id--)
+      writer.Add(id, make_bitfield(10 * id + 3, id));
+    writer.Close();
+  }
+
+  TSetArchiveReader reader(ArchivePath);
+  EXPECT_EQ(20, reader.GetCount());
+  EXPECT_TRUE(reader.Contains(7));
+  EXPECT_FALSE(reader.Contains(21));
+  EXPECT_EQ(make_bitfield(73, 7), reader.Load(7));
+  EXPECT_EQ(make_bitfield(13, 1), reader.Load(1));
+  EXPECT_EQ(TSet(make_bitfield(203, 20)), TSet(reader.Load(20)));
+
+  std::remove(ArchivePath);
+}
+
+TEST(TSetArchive, can_map_entry)
+{
+  {
+    TSetArchiveWriter writer(ArchivePath);
+    writer.Add(1, make_bitfield(5, 2));
+    writer.Add(2, make_bitfield(100, 3));
+  }
+
+  TSetArchiveReader reader(ArchivePath);
+  TBitFieldView view = reader.Map(2);
+
+  EXPECT_EQ(100, view.GetLength());
+  EXPECT_EQ(1, view.GetBit(99));
+  EXPECT_EQ(0, view.GetBit(98));
+  EXPECT_EQ(make_bitfield(100, 3), view.ToBitField());
+
+  std::remove(ArchivePath);
+}
+
+TEST(TSetArchive, throws_when_load_missing_id)
+{
+  {
+    TSetArchiveWriter writer(ArchivePath);
+    writer.Add(1, make_bitfield(5, 2));
+  }
+
+  TSetArchiveReader reader(ArchivePath);
+  ASSERT_ANY_THROW(reader.Load(2));
+
+  std::remove(ArchivePath);
+}
+
+TEST(TSetArchive, throws_when_ids_are_duplicated)
+{
+  TSetArchiveWriter writer(ArchivePath);
+  writer.Add(1, make_bitfield(5, 2));
+  writer.Add(1, make_bitfield(6, 2));
+
+  ASSERT_ANY_THROW(writer.Close());
+
+  std::remove(ArchivePath);
+}
+
+TEST(TSetArchive, throws_when_header_count_exceeds_file)
+{
+  {
+    TSetArchiveWriter writer(ArchivePath);
+    writer.Add(1, make_bitfield(5, 2));
+  }
+  {
+    // к-во записей в заголовке (смещение 16)
+    std::fstream file(ArchivePath, std::ios::binary | std::ios::in | std::ios::out);
+    const std::uint64_t count = 1ull << 60;
+    file.seekp(16);
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  }
+
+  ASSERT_THROW(TSetArchiveReader reader(ArchivePath), std::runtime_error);
+
+  std::remove(ArchivePath);
+}
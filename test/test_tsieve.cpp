@@ -0,0 +1,160 @@
+#include "tsieve.h"
+
+#include <gtest.h>
+
+static std::vector<long long> naive_primes(int n)
+{
+  std::vector<long long> primes;
+  for (int m = 2; m <= n; m++)
+  {
+    bool prime = true;
+    for (int d = 2; d * d <= m && prime; d++)
+      prime = m % d != 0;
+    if (prime)
+      primes.push_back(m);
+  }
+  return primes;
+}
+
+TEST(TSegmentedSieve, throws_when_segment_length_is_not_word_multiple)
+{
+  ASSERT_ANY_THROW(TSegmentedSieve sieve(100, 33));
+}
+
+TEST(TSegmentedSieve, counts_primes_for_small_limits)
+{
+  EXPECT_EQ(0, TSegmentedSieve(0).Count());
+  EXPECT_EQ(0, TSegmentedSieve(1).Count());
+  EXPECT_EQ(1, TSegmentedSieve(2).Count());
+  EXPECT_EQ(25, TSegmentedSieve(100).Count());
+}
+
+TEST(TSegmentedSieve, finds_same_primes_as_naive_search_across_segments)
+{
+  const int n = 5000;
+  TSegmentedSieve sieve(n, 64);
+
+  std::vector<long long> primes;
+  sieve.ForEachPrime([&primes](long long p) { primes.push_back(p); });
+
+  EXPECT_EQ(naive_primes(n), primes);
+}
+
+TEST(TSegmentedSieve, counts_primes_up_to_ten_million)
+{
+  EXPECT_EQ(664579, TSegmentedSieve(10000000).Count());
+}
+
+TEST(TWheel, index_and_value_are_inverse)
+{
+  const TSieveWheel wheels[] = { WheelNone, WheelOdd, Wheel30 };
+  for (TSieveWheel w : wheels)
+  {
+    const TWheel &wheel = TWheel::Get(w);
+    for (long long n = 0; n < 1000; n++)
+    {
+      if (wheel.Contains(n))
+      {
+        EXPECT_EQ(n, wheel.ValueOf(wheel.IndexOf(n)));
+      }
+    }
+  }
+}
+
+TEST(TWheel, wheel30_stores_8_numbers_of_30)
+{
+  const TWheel &wheel = TWheel::Get(Wheel30);
+
+  EXPECT_EQ(8, wheel.IndexOf(30));
+  EXPECT_TRUE(wheel.Contains(31));
+  EXPECT_FALSE(wheel.Contains(35));
+  EXPECT_EQ(wheel.IndexOf(37), wheel.IndexOf(36));
+}
+
+TEST(TSegmentedSieve, wheels_find_same_primes_as_naive_search)
+{
+  const int n = 5000;
+  const TSieveWheel wheels[] = { WheelOdd, Wheel30 };
+  for (TSieveWheel w : wheels)
+  {
+    TSegmentedSieve sieve(n, 64, w);
+
+    std::vector<long long> primes;
+    sieve.ForEachPrime([&primes](long long p) { primes.push_back(p); });
+
+    EXPECT_EQ(naive_primes(n), primes);
+  }
+}
+
+TEST(TSegmentedSieve, wheels_count_primes_for_small_limits)
+{
+  for (int n = 0; n < 100; n++)
+  {
+    const long long expected = (long long)naive_primes(n).size();
+    EXPECT_EQ(expected, TSegmentedSieve(n, 32, WheelOdd).Count());
+    EXPECT_EQ(expected, TSegmentedSieve(n, 32, Wheel30).Count());
+  }
+}
+
+TEST(TSegmentedSieve, wheel30_uses_fewer_bits)
+{
+  TSegmentedSieve sieve(3000000, SieveSegmentLen, Wheel30);
+
+  EXPECT_EQ(800000, sieve.GetIndexEnd());
+  EXPECT_EQ(216816, sieve.Count());
+}
+
+TEST(TSegmentedSieve, parallel_count_matches_sequential)
+{
+  TSegmentedSieve sieve(1000000, 1024, WheelOdd);
+
+  EXPECT_EQ(sieve.Count(), sieve.Count(4));
+  EXPECT_EQ(78498, sieve.Count(0));
+}
+
+TEST(TSegmentedSieve, parallel_primes_are_ordered)
+{
+  const int n = 20000;
+  TSegmentedSieve sieve(n, 128, Wheel30);
+
+  EXPECT_EQ(naive_primes(n), sieve.GetPrimes(3));
+}
+
+TEST(ParallelFor, passes_exception_to_caller)
+{
+  ASSERT_ANY_THROW(ParallelFor(100, 4, [](long long i)
+  {
+    if (i == 50)
+      throw std::runtime_error("task failed");
+  }));
+}
+
+TEST(TSegmentedSieve, presieve_keeps_small_primes_in_unaligned_ranges)
+{
+  const int n = 3000;
+  const TSieveWheel wheels[] = { WheelNone, WheelOdd, Wheel30 };
+  for (TSieveWheel w : wheels)
+  {
+    TSegmentedSieve sieve(n, 64, w);
+    const TWheel &wheel = sieve.GetWheel();
+
+    std::vector<long long> primes;
+    for (int p : { 2, 3, 5 })
+      if (!wheel.Contains(p))
+        primes.push_back(p);
+    sieve.ForEachSegment(0, 5, [&](long long low, const TBitField &window)
+    {
+      for (int i = 0; i < window.GetLength(); i++)
+        if (window.GetBit(i))
+          primes.push_back(wheel.ValueOf(low + i));
+    });
+    sieve.ForEachSegment(5, sieve.GetIndexEnd(), [&](long long low, const TBitField &window)
+    {
+      for (int i = 0; i < window.GetLength(); i++)
+        if (window.GetBit(i))
+          primes.push_back(wheel.ValueOf(low + i));
+    });
+
+    EXPECT_EQ(naive_primes(n), primes);
+  }
+}